@@ -0,0 +1,848 @@
+//**************************************************
+// \file G4HadFSBenchmark.cc
+// \brief: main() of G4HadFSGenerator benchmarks
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "G4Alpha.hh"
+#include "G4AntiAlpha.hh"
+#include "G4AntiDeuteron.hh"
+#include "G4AntiHe3.hh"
+#include "G4AntiProton.hh"
+#include "G4AntiTriton.hh"
+#include "G4Deuteron.hh"
+#include "G4GenericIon.hh"
+#include "G4He3.hh"
+#include "G4KaonPlus.hh"
+#include "G4Lambda.hh"
+#include "G4Material.hh"
+#include "G4NistManager.hh"
+#include "G4Neutron.hh"
+#include "G4NucleiProperties.hh"
+#include "G4Nucleus.hh"
+#include "G4OmegaMinus.hh"
+#include "G4ParticleTable.hh"
+#include "G4PionMinus.hh"
+#include "G4PionPlus.hh"
+#include "G4Proton.hh"
+#include "G4SigmaMinus.hh"
+#include "G4SigmaPlus.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Triton.hh"
+#include "G4UIcommand.hh"
+#include "G4VParticleChange.hh"
+#include "G4Version.hh"
+#include "G4XiMinus.hh"
+#include "G4XiZero.hh"
+#include "G4ios.hh"
+#include "FinalStateLibrary.hh"
+#include "HadronicGenerator.hh"
+#include "HistoAccumulator.hh"
+#include "Randomize.hh"
+#include "SecondariesBuffer.hh"
+#include "globals.hh"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#if G4VERSION_NUMBER < 1100
+#include "g4root.hh" // replaced by G4AnalysisManager.h  in G4 v11 and up
+#else
+#include "G4AnalysisManager.hh"
+#endif
+
+// Count every heap allocation done by the process (our code, Geant4
+// and the hadronic models)
+//
+namespace alloc {
+std::atomic<std::size_t> count{0};
+}
+
+void *operator new(std::size_t size) {
+  alloc::count.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace mem {
+// Current resident set size (MB), from /proc/self/statm (Linux only)
+//
+G4double GetRSS() {
+  long pages = 0;
+  long residentPages = 0;
+  std::ifstream statm("/proc/self/statm");
+  if (!(statm >> pages >> residentPages)) {
+    return -1.;
+  }
+  return residentPages * sysconf(_SC_PAGESIZE) / (1024. * 1024.);
+}
+
+// Peak resident set size (MB)
+//
+G4double GetPeakRSS() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024. * 1024.); // bytes
+#else
+  return usage.ru_maxrss / 1024.; // kilobytes
+#endif
+}
+} // namespace mem
+
+namespace CLIoutput {
+void PrintError() {
+  G4cerr << "Wrong usage. Options:\n"
+         << "-pl physicslist (FTFP_BERT)\n"
+         << "-p particle (pi-)\n"
+         << "-e energy_geV (10)\n"
+         << "-m g4material (G4_Cu)\n"
+         << "-n interactions (100000, per grid point for suite: 1000)\n"
+         << "-b benchmark: allocations/applicable/init/replay/batch/histo/"
+            "suite (allocations)\n"
+         << "-o JSON output of suite (G4HadFSBenchmark.json)\n"
+         << G4endl;
+}
+} // namespace CLIoutput
+
+namespace bench {
+// Sample one interaction and release its secondaries, returns the number of
+// secondaries
+//
+G4int Interact(HadronicGenerator *theHadronicGenerator,
+               G4ParticleDefinition *projectile, G4double energy,
+               G4Material *material) {
+  const G4ThreeVector aDirection = G4ThreeVector(0.0, 0.0, 1.0);
+  G4VParticleChange *aChange = theHadronicGenerator->GenerateInteraction(
+      projectile, energy, aDirection, material);
+  if (aChange == nullptr) {
+    return 0;
+  }
+  // Released here rather than at the next call, so that the allocations of
+  // a call are balanced by its own deallocations
+  //
+  const G4int nSecondaries = aChange->GetNumberOfSecondaries();
+  theHadronicGenerator->ReleaseInteraction();
+  return nSecondaries;
+}
+
+// Call GenerateInteraction n times, in 10 checkpoints, and print the
+// allocations per call and the RSS at each checkpoint
+//
+void Allocations(HadronicGenerator *theHadronicGenerator,
+                 G4ParticleDefinition *projectile, G4double energy,
+                 G4Material *material, std::size_t n) {
+  const std::size_t nCheckpoints = 10;
+  const std::size_t nPerCheckpoint =
+      std::max<std::size_t>(n / nCheckpoints, 1);
+
+  G4cout << "=== Allocations per GenerateInteraction call ===" << G4endl
+         << "calls allocs/call ns/call RSS(MB)" << G4endl;
+  std::size_t calls = 0;
+  for (std::size_t c = 0; c < nCheckpoints; c++) {
+    const std::size_t allocStart = alloc::count.load();
+    const auto timeStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < nPerCheckpoint; i++) {
+      Interact(theHadronicGenerator, projectile, energy, material);
+    }
+    const auto timeStop = std::chrono::steady_clock::now();
+    calls += nPerCheckpoint;
+    const G4double ns =
+        std::chrono::duration<G4double, std::nano>(timeStop - timeStart)
+            .count();
+    G4cout << calls << " "
+           << G4double(alloc::count.load() - allocStart) / nPerCheckpoint
+           << " " << ns / nPerCheckpoint << " " << mem::GetRSS() << G4endl;
+  }
+  G4cout << "Peak RSS (MB): " << mem::GetPeakRSS() << G4endl;
+}
+
+// Reference copy of HadronicGenerator::IsApplicable before the applicability
+// table, comparing the physics case name and the particle definitions at
+// each call
+//
+G4bool LegacyIsApplicable(const G4String &physicsCase,
+                          G4ParticleDefinition *projectileDefinition,
+                          const G4double projectileEnergy) {
+  if (projectileDefinition == nullptr)
+    return false;
+  G4bool isApplicable = true;
+  if (physicsCase == "BERT") {
+    if (((projectileDefinition != G4PionMinus::Definition()) &&
+         (projectileDefinition != G4PionPlus::Definition()) &&
+         (projectileDefinition != G4Proton::Definition()) &&
+         (projectileDefinition != G4Neutron::Definition()) &&
+         (projectileDefinition != G4Lambda::Definition()) &&
+         (projectileDefinition != G4SigmaMinus::Definition()) &&
+         (projectileDefinition != G4SigmaPlus::Definition()) &&
+         (projectileDefinition != G4XiMinus::Definition()) &&
+         (projectileDefinition != G4XiZero::Definition()) &&
+         (projectileDefinition != G4OmegaMinus::Definition())) ||
+        (projectileEnergy > 15.0 * CLHEP::GeV)) {
+      isApplicable = false;
+    }
+  } else if (physicsCase == "QGSP") {
+    if (projectileEnergy < 2.0 * CLHEP::GeV ||
+        projectileDefinition == G4Deuteron::Definition() ||
+        projectileDefinition == G4Triton::Definition() ||
+        projectileDefinition == G4He3::Definition() ||
+        projectileDefinition == G4Alpha::Definition() ||
+        projectileDefinition == G4GenericIon::Definition() ||
+        projectileDefinition == G4AntiDeuteron::Definition() ||
+        projectileDefinition == G4AntiTriton::Definition() ||
+        projectileDefinition == G4AntiHe3::Definition() ||
+        projectileDefinition == G4AntiAlpha::Definition()) {
+      isApplicable = false;
+    }
+  } else if (physicsCase == "BIC" || physicsCase == "INCL") {
+    if (((projectileDefinition != G4PionMinus::Definition()) &&
+         (projectileDefinition != G4PionPlus::Definition()) &&
+         (projectileDefinition != G4Proton::Definition()) &&
+         (projectileDefinition != G4Neutron::Definition())) ||
+        (projectileEnergy > 10.0 * CLHEP::GeV)) {
+      isApplicable = false;
+    }
+  } else if (physicsCase == "IonBIC") {
+    if (!((projectileDefinition == G4Deuteron::Definition() &&
+           projectileEnergy < 2 * 10.0 * CLHEP::GeV) ||
+          (projectileDefinition == G4Triton::Definition() &&
+           projectileEnergy < 3 * 10.0 * CLHEP::GeV) ||
+          (projectileDefinition == G4He3::Definition() &&
+           projectileEnergy < 3 * 10.0 * CLHEP::GeV) ||
+          (projectileDefinition == G4Alpha::Definition() &&
+           projectileEnergy < 4 * 10.0 * CLHEP::GeV))) {
+      isApplicable = false;
+    }
+  }
+  return isApplicable;
+}
+
+// Time IsApplicable against the legacy string-compare version over a mix of
+// projectiles and energies, and check that both give the same answers
+//
+void Applicable(HadronicGenerator *theHadronicGenerator,
+                const G4String &physicsCase, std::size_t n) {
+  const std::vector<G4ParticleDefinition *> projectiles = {
+      G4PionMinus::Definition(),  G4PionPlus::Definition(),
+      G4Proton::Definition(),     G4Neutron::Definition(),
+      G4KaonPlus::Definition(),   G4Lambda::Definition(),
+      G4Alpha::Definition(),      G4AntiProton::Definition(),
+      G4AntiAlpha::Definition(),  G4GenericIon::Definition(),
+      G4OmegaMinus::Definition(), G4Deuteron::Definition()};
+  const std::vector<G4double> energies = {
+      0.1 * CLHEP::GeV, 1.0 * CLHEP::GeV,  5.0 * CLHEP::GeV,
+      10.0 * CLHEP::GeV, 15.0 * CLHEP::GeV, 30.0 * CLHEP::GeV,
+      100.0 * CLHEP::GeV};
+  const std::size_t nCombinations = projectiles.size() * energies.size();
+  const std::size_t nLoops = std::max<std::size_t>(n / nCombinations, 1);
+
+  std::size_t mismatches = 0;
+  for (auto projectile : projectiles) {
+    for (auto energy : energies) {
+      if (theHadronicGenerator->IsApplicable(projectile, energy) !=
+          LegacyIsApplicable(physicsCase, projectile, energy)) {
+        mismatches++;
+      }
+    }
+  }
+
+  std::size_t nApplicable = 0;
+  auto timeStart = std::chrono::steady_clock::now();
+  for (std::size_t l = 0; l < nLoops; l++) {
+    for (auto projectile : projectiles) {
+      for (auto energy : energies) {
+        nApplicable += LegacyIsApplicable(physicsCase, projectile, energy);
+      }
+    }
+  }
+  auto timeStop = std::chrono::steady_clock::now();
+  const G4double legacyNs =
+      std::chrono::duration<G4double, std::nano>(timeStop - timeStart)
+          .count() /
+      (nLoops * nCombinations);
+
+  timeStart = std::chrono::steady_clock::now();
+  for (std::size_t l = 0; l < nLoops; l++) {
+    for (auto projectile : projectiles) {
+      for (auto energy : energies) {
+        nApplicable += theHadronicGenerator->IsApplicable(projectile, energy);
+      }
+    }
+  }
+  timeStop = std::chrono::steady_clock::now();
+  const G4double tableNs =
+      std::chrono::duration<G4double, std::nano>(timeStop - timeStart)
+          .count() /
+      (nLoops * nCombinations);
+
+  G4cout << "=== IsApplicable cost (" << physicsCase << ") ===" << G4endl
+         << "string compares (ns/check): " << legacyNs << G4endl
+         << "applicability table (ns/check): " << tableNs << G4endl
+         << "mismatches: " << mismatches << " (applicable: " << nApplicable
+         << ")" << G4endl;
+}
+
+// Build a small final-state library (1000 interactions) with the
+// generator, reopen it, check its first interaction against the
+// generator output (as stored and as replayed along +z), and time n
+// Sample + Replay calls (random direction, boost to a 5% higher energy)
+// against GenerateInteraction
+//
+G4bool Replay(HadronicGenerator *theHadronicGenerator,
+              G4ParticleDefinition *projectile, G4double energy,
+              G4Material *material, std::size_t n) {
+  const G4String fileName = "G4HadFSBenchmark_fslib.bin";
+  const std::size_t nBuild = 1000;
+  const G4ThreeVector zAxis(0.0, 0.0, 1.0);
+  FinalStateLibraryWriter writer;
+  std::vector<FinalStateLibrary::Particle> reference; // first interaction
+  G4int referenceZ = 0;
+  const auto buildStart = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < nBuild; i++) {
+    G4VParticleChange *aChange = theHadronicGenerator->GenerateInteraction(
+        projectile, energy, zAxis, material);
+    if (aChange == nullptr) {
+      G4cerr << "Projectile not applicable" << G4endl;
+      return false;
+    }
+    const G4Nucleus *target =
+        theHadronicGenerator->GetHadronicProcess()->GetTargetNucleus();
+    const G4int targetZ = target->GetZ_asInt();
+    writer.BeginInteraction(
+        projectile->GetPDGEncoding(), energy, targetZ,
+        projectile->GetPDGMass(),
+        G4NucleiProperties::GetNuclearMass(target->GetA_asInt(), targetZ));
+    for (G4int j = 0; j < aChange->GetNumberOfSecondaries(); j++) {
+      const G4DynamicParticle *particle =
+          aChange->GetSecondary(j)->GetDynamicParticle();
+      const G4int pdg = particle->GetDefinition()->GetPDGEncoding();
+      const G4LorentzVector momentum = particle->Get4Momentum();
+      writer.AddSecondary(pdg, momentum.px(), momentum.py(), momentum.pz(),
+                          momentum.e());
+      if (i == 0) {
+        reference.push_back({pdg, momentum});
+      }
+    }
+    if (i == 0) {
+      referenceZ = targetZ;
+    }
+  }
+  theHadronicGenerator->ReleaseInteraction();
+  const auto buildStop = std::chrono::steady_clock::now();
+  if (!writer.Write(fileName, "G4HadFSBenchmark")) {
+    return false;
+  }
+
+  FinalStateLibrary library;
+  if (!library.Open(fileName)) {
+    return false;
+  }
+  std::remove(fileName.c_str()); // the mapping stays valid
+
+  // First interaction of the bin of the reference target element: the
+  // first one sampled on that element
+  //
+  const fslib::Bin *bin =
+      library.FindBin(projectile->GetPDGEncoding(), referenceZ, energy);
+  std::size_t mismatches = 0;
+  std::vector<FinalStateLibrary::Particle> particles;
+  if (bin == nullptr) {
+    mismatches++;
+  } else {
+    const FinalStateLibrary::Interaction interaction =
+        library.GetInteraction(*bin, 0);
+    library.Replay(interaction, zAxis, energy, false,
+                   *CLHEP::HepRandom::getTheEngine(), particles);
+    mismatches += interaction.nSecondaries != reference.size();
+    for (std::size_t j = 0;
+         j < std::min(particles.size(), reference.size()); j++) {
+      const G4LorentzVector &expected = reference[j].momentum;
+      const G4LorentzVector &replayed = particles[j].momentum;
+      const G4double tolerance = 1e-6 * expected.e(); // single precision
+      mismatches +=
+          particles[j].pdg != reference[j].pdg ||
+          interaction.secondaries[j].pdg != reference[j].pdg ||
+          std::abs(interaction.secondaries[j].px - expected.px()) >
+              tolerance ||
+          std::abs(interaction.secondaries[j].py - expected.py()) >
+              tolerance ||
+          std::abs(replayed.e() - expected.e()) > tolerance ||
+          std::abs(replayed.pz() - expected.pz()) > tolerance ||
+          std::abs(replayed.perp() - expected.perp()) > tolerance;
+    }
+  }
+
+  // Timing
+  //
+  CLHEP::HepRandomEngine &engine = *CLHEP::HepRandom::getTheEngine();
+  const G4ThreeVector direction = G4ThreeVector(0.3, 0.4, 1.0).unit();
+  std::size_t nSecondaries = 0;
+  const auto replayStart = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < n; i++) {
+    const FinalStateLibrary::Interaction interaction = library.Sample(
+        projectile->GetPDGEncoding(), referenceZ, 1.05 * energy, engine);
+    library.Replay(interaction, direction, 1.05 * energy, true, engine,
+                   particles);
+    nSecondaries += particles.size();
+  }
+  const auto replayStop = std::chrono::steady_clock::now();
+  const G4double generateNs =
+      std::chrono::duration<G4double, std::nano>(buildStop - buildStart)
+          .count() /
+      nBuild;
+  const G4double replayNs =
+      std::chrono::duration<G4double, std::nano>(replayStop - replayStart)
+          .count() /
+      n;
+
+  G4cout << "=== Final-state library replay ===" << G4endl
+         << "library: " << nBuild << " interactions in " << library.GetNBins()
+         << " bins" << G4endl
+         << "check of the first interaction: "
+         << (mismatches == 0 ? "ok" : "FAILED") << " (" << reference.size()
+         << " secondaries, " << mismatches << " mismatches)" << G4endl
+         << "GenerateInteraction (ns/call): " << generateNs << G4endl
+         << "Sample + Replay (ns/call): " << replayNs << " ("
+         << (nSecondaries > 0 ? replayNs * n / nSecondaries : 0.)
+         << " ns/secondary, speed-up " << generateNs / replayNs << ")"
+         << G4endl;
+  return mismatches == 0;
+}
+
+// Time n interactions sampled one by one with GenerateInteraction, reading
+// the secondaries through G4Track and G4DynamicParticle, against batches of
+// GenerateInteractions read from the flat columns of a SecondariesBuffer.
+// Both runs start from the same seeds and sum the kinetic energy and pz of
+// the charged pions, which must agree
+//
+G4bool Batch(HadronicGenerator *theHadronicGenerator,
+             G4ParticleDefinition *projectile, G4double energy,
+             G4Material *material, std::size_t n) {
+  const G4ThreeVector zAxis(0.0, 0.0, 1.0);
+  const long seeds[3] = {12345, 67890, 0};
+  CLHEP::HepRandomEngine &engine = *CLHEP::HepRandom::getTheEngine();
+  if (!theHadronicGenerator->IsApplicable(projectile, energy)) {
+    G4cerr << "Projectile not applicable" << G4endl;
+    return false;
+  }
+  // Warm-up: the first call may build tables and draw random numbers
+  //
+  Interact(theHadronicGenerator, projectile, energy, material);
+
+  engine.setSeeds(seeds, -1);
+  G4double singleEkin = 0.;
+  G4double singlePz = 0.;
+  const auto singleStart = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < n; i++) {
+    G4VParticleChange *aChange = theHadronicGenerator->GenerateInteraction(
+        projectile, energy, zAxis, material);
+    for (G4int j = 0; j < aChange->GetNumberOfSecondaries(); j++) {
+      const G4DynamicParticle *particle =
+          aChange->GetSecondary(j)->GetDynamicParticle();
+      if (std::abs(particle->GetDefinition()->GetPDGEncoding()) == 211) {
+        singleEkin += particle->GetKineticEnergy();
+        singlePz += particle->Get4Momentum().pz();
+      }
+    }
+  }
+  theHadronicGenerator->ReleaseInteraction();
+  const auto singleStop = std::chrono::steady_clock::now();
+
+  engine.setSeeds(seeds, -1);
+  const G4int batchSize = 1000;
+  SecondariesBuffer secondaries;
+  secondaries.Reserve(batchSize, 100 * batchSize);
+  G4double batchEkin = 0.;
+  G4double batchPz = 0.;
+  G4double loopNs = 0.;
+  std::size_t nSecondaries = 0;
+  const auto batchStart = std::chrono::steady_clock::now();
+  for (std::size_t first = 0; first < n; first += batchSize) {
+    const G4int nBatch =
+        static_cast<G4int>(std::min<std::size_t>(batchSize, n - first));
+    theHadronicGenerator->GenerateInteractions(projectile, energy, zAxis,
+                                               material, nBatch, secondaries);
+    const auto loopStart = std::chrono::steady_clock::now();
+    const std::size_t size = secondaries.GetNumberOfSecondaries();
+    const G4int *pdg = secondaries.GetPDG();
+    const G4double *ekin = secondaries.GetEkin();
+    const G4double *pz = secondaries.GetPz();
+    for (std::size_t j = 0; j < size; j++) {
+      if (std::abs(pdg[j]) == 211) {
+        batchEkin += ekin[j];
+        batchPz += pz[j];
+      }
+    }
+    loopNs += std::chrono::duration<G4double, std::nano>(
+                  std::chrono::steady_clock::now() - loopStart)
+                  .count();
+    nSecondaries += size;
+  }
+  const auto batchStop = std::chrono::steady_clock::now();
+
+  const G4bool match = singleEkin == batchEkin && singlePz == batchPz;
+  const G4double singleNs =
+      std::chrono::duration<G4double, std::nano>(singleStop - singleStart)
+          .count() /
+      n;
+  const G4double batchNs =
+      std::chrono::duration<G4double, std::nano>(batchStop - batchStart)
+          .count() /
+      n;
+  G4cout << "=== Batched GenerateInteractions ===" << G4endl
+         << "check of the pi+- sums: " << (match ? "ok" : "FAILED") << " ("
+         << singleEkin / CLHEP::GeV << " vs " << batchEkin / CLHEP::GeV
+         << " GeV)" << G4endl
+         << "GenerateInteraction (ns/interaction): " << singleNs << G4endl
+         << "GenerateInteractions, batches of " << batchSize
+         << " (ns/interaction): " << batchNs << G4endl
+         << "loop over the columns (ns/secondary): "
+         << (nSecondaries > 0 ? loopNs / nSecondaries : 0.) << G4endl;
+  return match;
+}
+
+// Time n fills of a 1000-bin histogram with H1Accumulator::Fill against
+// G4AnalysisManager::FillH1, with the same values (10% of them outside the
+// range), and check that the accumulator written into a booked histogram
+// has the same entries and mean as the one filled with FillH1
+//
+G4bool Histo(std::size_t n) {
+  const G4int nBins = 1000;
+  std::vector<G4double> values(n);
+  for (G4double &value : values) {
+    value = 1.1 * G4UniformRand() - 0.05;
+  }
+  auto analysisManager = G4AnalysisManager::Instance();
+  const G4int filledId =
+      analysisManager->CreateH1("FillH1", "FillH1", nBins, 0., 1.);
+  const G4int writtenId = analysisManager->CreateH1(
+      "H1Accumulator", "H1Accumulator", nBins, 0., 1.);
+
+  auto timeStart = std::chrono::steady_clock::now();
+  for (G4double value : values) {
+    analysisManager->FillH1(filledId, value);
+  }
+  auto timeStop = std::chrono::steady_clock::now();
+  const G4double fillH1Ns =
+      std::chrono::duration<G4double, std::nano>(timeStop - timeStart)
+          .count() /
+      n;
+
+  H1Accumulator accumulator(nBins, 0., 1.);
+  timeStart = std::chrono::steady_clock::now();
+  for (G4double value : values) {
+    accumulator.Fill(value);
+  }
+  timeStop = std::chrono::steady_clock::now();
+  const G4double accumulatorNs =
+      std::chrono::duration<G4double, std::nano>(timeStop - timeStart)
+          .count() /
+      n;
+
+  const auto *filled = analysisManager->GetH1(filledId);
+  const auto *written = analysisManager->GetH1(writtenId);
+  const G4bool match =
+      accumulator.WriteTo(*analysisManager->GetH1(writtenId)) &&
+      filled->all_entries() == written->all_entries() &&
+      std::abs(filled->mean() - written->mean()) <=
+          1e-9 * std::abs(filled->mean());
+  G4cout << "=== Histogram filling ===" << G4endl
+         << "check of entries and mean: " << (match ? "ok" : "FAILED")
+         << G4endl << "G4AnalysisManager::FillH1 (ns/fill): " << fillH1Ns
+         << G4endl << "H1Accumulator::Fill (ns/fill): " << accumulatorNs
+         << " (speed-up " << fillH1Ns / accumulatorNs << ")" << G4endl;
+  return match;
+}
+
+// Set up the projectile and print the initialization time of each component,
+// and the RSS before the generator, after its constructor and after the
+// projectile set-up
+//
+void Init(HadronicGenerator *theHadronicGenerator,
+          G4ParticleDefinition *projectile, G4double rssBefore,
+          G4double rssConstructor) {
+  const std::size_t allocsBefore = alloc::count.load();
+  theHadronicGenerator->PrepareProjectile(projectile);
+  const std::size_t allocs = alloc::count.load() - allocsBefore;
+  theHadronicGenerator->PrintInitTimes();
+  G4cout << "RSS before HadronicGenerator (MB): " << rssBefore << G4endl
+         << "RSS after constructor (MB): " << rssConstructor << G4endl
+         << "RSS after projectile set-up (MB): " << mem::GetRSS()
+         << " (allocations: " << allocs << ")" << G4endl;
+}
+} // namespace bench
+
+namespace suite {
+// Physics cases of HadronicGenerator, and the fixed grid run for each of
+// them (points where the physics case is not applicable are skipped)
+//
+const std::vector<G4String> physicsCases{
+    "FTFP_BERT", "FTFP_BERT_ATL", "QGSP_BERT", "QGSP_BIC", "FTFP_INCLXX",
+    "FTFP",      "QGSP",          "BERT",      "BIC",      "IonBIC",
+    "INCL"};
+const std::vector<G4String> projectiles{"pi-", "pi+", "proton", "neutron",
+                                        "kaon+", "alpha"};
+const std::vector<G4double> energies{1., 5., 10., 100.}; // GeV
+const std::vector<G4String> materials{"G4_C", "G4_Cu", "G4_Pb"};
+
+// Run the grid for one physics case, writing one JSON object per point
+// (one per line) to json
+//
+void RunGrid(const G4String &physicsCase, std::size_t n, std::ostream &json) {
+  std::unique_ptr<HadronicGenerator> theHadronicGenerator(
+      new HadronicGenerator(physicsCase));
+  G4ParticleTable *partTable = G4ParticleTable::GetParticleTable();
+  partTable->SetReadiness();
+  const std::size_t nWarmUp = std::max<std::size_t>(n / 10, 1);
+
+  for (const G4String &nameProjectile : projectiles) {
+    G4ParticleDefinition *projectile = partTable->FindParticle(nameProjectile);
+    if (projectile == nullptr) {
+      continue;
+    }
+    for (G4double energyProjectile : energies) {
+      const G4double energy = energyProjectile * CLHEP::GeV;
+      if (!theHadronicGenerator->IsApplicable(projectile, energy)) {
+        continue;
+      }
+      theHadronicGenerator->PrepareProjectile(projectile);
+      for (const G4String &nameMaterial : materials) {
+        G4Material *material =
+            G4NistManager::Instance()->FindOrBuildMaterial(nameMaterial);
+
+        // Warm up, so that on-demand initialization is not timed
+        //
+        for (std::size_t i = 0; i < nWarmUp; i++) {
+          bench::Interact(theHadronicGenerator.get(), projectile, energy,
+                          material);
+        }
+
+        std::size_t nSecondaries = 0;
+        const std::size_t allocStart = alloc::count.load();
+        const auto timeStart = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < n; i++) {
+          nSecondaries += bench::Interact(theHadronicGenerator.get(),
+                                          projectile, energy, material);
+        }
+        const auto timeStop = std::chrono::steady_clock::now();
+        const std::size_t allocs = alloc::count.load() - allocStart;
+        const G4double ns =
+            std::chrono::duration<G4double, std::nano>(timeStop - timeStart)
+                .count();
+
+        json << "{\"physics\": \"" << physicsCase << "\", \"projectile\": \""
+             << nameProjectile << "\", \"energy_GeV\": " << energyProjectile
+             << ", \"material\": \"" << nameMaterial
+             << "\", \"interactions\": " << n
+             << ", \"interactions_per_s\": " << n / (ns * 1e-9)
+             << ", \"ns_per_secondary\": "
+             << (nSecondaries > 0 ? ns / nSecondaries : 0.)
+             << ", \"secondaries_per_call\": "
+             << G4double(nSecondaries) / n
+             << ", \"allocations_per_call\": " << G4double(allocs) / n
+             << ", \"peak_rss_MB\": " << mem::GetPeakRSS() << "}\n";
+        G4cout << physicsCase << " " << nameProjectile << " "
+               << energyProjectile << " GeV " << nameMaterial << ": "
+               << n / (ns * 1e-9) << " interactions/s" << G4endl;
+      }
+    }
+  }
+}
+
+// Run every physics case in its own child process, so that each one starts
+// from a clean Geant4 state and has its own peak RSS, and collect the
+// results in a JSON file
+//
+G4bool Run(std::size_t n, const G4String &fileName) {
+  std::vector<G4String> results;
+  for (const G4String &physicsCase : physicsCases) {
+    G4int fd[2];
+    if (pipe(fd) != 0) {
+      G4cerr << "suite: cannot create a pipe" << G4endl;
+      return false;
+    }
+    std::cout.flush();
+    std::fflush(nullptr);
+    const pid_t pid = fork();
+    if (pid == 0) {
+      close(fd[0]);
+      std::ostringstream json;
+      RunGrid(physicsCase, n, json);
+      const std::string output = json.str();
+      std::size_t written = 0;
+      while (written < output.size()) {
+        const ssize_t size =
+            write(fd[1], output.data() + written, output.size() - written);
+        if (size <= 0) {
+          break;
+        }
+        written += size;
+      }
+      std::cout.flush();
+      _exit(written == output.size() ? 0 : 1);
+    }
+    close(fd[1]);
+    if (pid < 0) {
+      close(fd[0]);
+      G4cerr << "suite: cannot fork" << G4endl;
+      return false;
+    }
+    std::string output;
+    char buffer[4096];
+    ssize_t size;
+    while ((size = read(fd[0], buffer, sizeof(buffer))) > 0) {
+      output.append(buffer, size);
+    }
+    close(fd[0]);
+    G4int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      G4cerr << "suite: " << physicsCase << " failed, skipped" << G4endl;
+      continue;
+    }
+    std::istringstream lines(output);
+    std::string line;
+    while (std::getline(lines, line)) {
+      results.push_back(line);
+    }
+  }
+
+  std::ofstream file(fileName);
+  if (!file) {
+    G4cerr << "suite: cannot open " << fileName << G4endl;
+    return false;
+  }
+  file << "{\n  \"geant4\": " << G4VERSION_NUMBER
+       << ",\n  \"interactions\": " << n << ",\n  \"results\": [";
+  for (std::size_t i = 0; i < results.size(); i++) {
+    file << (i == 0 ? "\n    " : ",\n    ") << results[i];
+  }
+  file << "\n  ]\n}\n";
+  G4cout << "Results (" << results.size() << " points) written to "
+         << fileName << G4endl;
+  return true;
+}
+} // namespace suite
+
+int main(int argc, char **argv) {
+
+  G4cout << "=== Benchmarking HadronicGenerator ===" << G4endl;
+  G4cout << "=== Using Geant4: " << G4VERSION_NUMBER << G4endl;
+
+  G4String namePhysics = "FTFP_BERT";
+  G4String nameProjectile = "pi-";
+  G4double energyProjectile = 10.;
+  G4String nameMaterial = "G4_Cu";
+  std::size_t nInteractions = 0;
+  G4String nameBenchmark = "allocations";
+  G4String nameOutput = "G4HadFSBenchmark.json";
+
+  for (G4int i = 1; i < argc; i = i + 2) {
+    if (i + 1 >= argc) {
+      CLIoutput::PrintError();
+      return 1;
+    }
+    if (G4String(argv[i]) == "-pl")
+      namePhysics = argv[i + 1];
+    else if (G4String(argv[i]) == "-p")
+      nameProjectile = argv[i + 1];
+    else if (G4String(argv[i]) == "-e")
+      energyProjectile = G4UIcommand::ConvertToDouble(argv[i + 1]);
+    else if (G4String(argv[i]) == "-m")
+      nameMaterial = argv[i + 1];
+    else if (G4String(argv[i]) == "-n")
+      nInteractions = G4UIcommand::ConvertToInt(argv[i + 1]);
+    else if (G4String(argv[i]) == "-b")
+      nameBenchmark = argv[i + 1];
+    else if (G4String(argv[i]) == "-o")
+      nameOutput = argv[i + 1];
+    else {
+      CLIoutput::PrintError();
+      return 1;
+    }
+  }
+
+  if (nInteractions == 0) {
+    nInteractions = nameBenchmark == "suite" ? 1000 : 100000;
+  }
+
+  // The suite builds its own generators, one per physics case
+  //
+  if (nameBenchmark == "suite") {
+    const G4bool done = suite::Run(nInteractions, nameOutput);
+    G4cout << "The end." << G4endl;
+    return done ? 0 : 1;
+  }
+
+  const G4double rssBefore = mem::GetRSS();
+  std::unique_ptr<HadronicGenerator> theHadronicGenerator(
+      new HadronicGenerator(namePhysics));
+  const G4double rssConstructor = mem::GetRSS();
+  G4ParticleTable *partTable = G4ParticleTable::GetParticleTable();
+  partTable->SetReadiness();
+  G4ParticleDefinition *projectile = partTable->FindParticle(nameProjectile);
+  G4Material *material =
+      G4NistManager::Instance()->FindOrBuildMaterial(nameMaterial);
+  if (projectile == nullptr || material == nullptr) {
+    CLIoutput::PrintError();
+    return 1;
+  }
+
+  G4cout << "Model: " << namePhysics << " Projectile: " << nameProjectile
+         << " Ekin: " << energyProjectile << " GeV Material: " << nameMaterial
+         << G4endl;
+  if (nameBenchmark == "init") {
+    bench::Init(theHadronicGenerator.get(), projectile, rssBefore,
+                rssConstructor);
+  } else if (nameBenchmark == "allocations") {
+    theHadronicGenerator->PrepareProjectile(projectile);
+    bench::Allocations(theHadronicGenerator.get(), projectile,
+                       energyProjectile * CLHEP::GeV, material, nInteractions);
+  } else if (nameBenchmark == "applicable") {
+    bench::Applicable(theHadronicGenerator.get(), namePhysics, nInteractions);
+  } else if (nameBenchmark == "replay") {
+    theHadronicGenerator->PrepareProjectile(projectile);
+    if (!bench::Replay(theHadronicGenerator.get(), projectile,
+                       energyProjectile * CLHEP::GeV, material,
+                       nInteractions)) {
+      return 1;
+    }
+  } else if (nameBenchmark == "histo") {
+    if (!bench::Histo(nInteractions)) {
+      return 1;
+    }
+  } else if (nameBenchmark == "batch") {
+    theHadronicGenerator->PrepareProjectile(projectile);
+    if (!bench::Batch(theHadronicGenerator.get(), projectile,
+                      energyProjectile * CLHEP::GeV, material,
+                      nInteractions)) {
+      return 1;
+    }
+  } else {
+    CLIoutput::PrintError();
+    return 1;
+  }
+  G4cout << "The end." << G4endl;
+}
+
+//**************************************************
@@ -18,20 +18,46 @@
 #include "G4UnitsTable.hh"
 #include "G4VParticleChange.hh"
 #include "G4Version.hh"
+#include "ConservationChecker.hh"
+#include "EarlyStop.hh"
+#include "EnergySpectrum.hh"
+#include "EventWriter.hh"
+#include "FinalStateLibrary.hh"
 #include "G4ios.hh"
 #include "HadronicGenerator.hh"
+#include "HistoAccumulator.hh"
+#include "InteractionProfiler.hh"
+#include "NtupleWriter.hh"
+#include "SecondariesBuffer.hh"
+#include "SeedJournal.hh"
 #include "globals.hh"
 #include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
 #if G4VERSION_NUMBER < 1100
 #include "g4root.hh" // replaced by G4AnalysisManager.h  in G4 v11 and up
 #else
 #include "G4AnalysisManager.hh"
 #endif
+#include "G4HadronicInteraction.hh"
 #include "G4NucleiProperties.hh"
+#include "G4Nucleus.hh"
+#include "G4Threading.hh"
+#include <cctype>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace pl {
 std::vector<G4String> list{"FTFP_BERT", "FTFP_BERT_ATL", "QGSP_BERT",
@@ -44,168 +70,757 @@ namespace CLIoutput {
 void PrintError() {
   G4cerr << "Wrong usage. Options:\n"
          << "-pl physicslist (FTFP_BERT)\n"
-         << "-p particle (proton)\n"
-         << "-e energy_geV (100)\n"
-         << "-m g4material (G4_Fe)\n"
+         << "-p particle(s), comma-separated (proton)\n"
+         << "-e energy_geV(s), comma-separated, ranges as min:max:logN or "
+            "min:max:linN (100)\n"
+         << "-spectrum flat:min:max, logflat:min:max, power:min:max:gamma "
+            "(GeV) or a file of energy (GeV) and density, instead of -e\n"
+         << "-m g4material(s), comma-separated (G4_Fe)\n"
+         << "-n events per point (optional, 100000)\n"
+         << "-precision observable:relative_error, comma-separated, "
+            "observables eloss, neutron, pi0 (optional, stop early)\n"
+         << "-time seconds per point (optional, stop early)\n"
+         << "-runseed seed (optional, 123)\n"
          << "-seed 1/0 (optional)\n"
-         << "-redo 1/0 (optional)\n"
+         << "-redo event id(s), comma-separated, or a file of ids (optional)\n"
+         << "-anomaly predicate(s), comma-separated, as quantity<value or "
+            "quantity>value, quantities mom, absmom, eloss, elossoverb, nsec "
+            "(optional, capture the anomalous events)\n"
+         << "-anomalysecondaries 1/0 (optional, also their secondaries)\n"
+         << "-t threads (optional, 1)\n"
+         << "-shard k/N (optional, slice k of N of the event range)\n"
+         << "-xscache directory (optional, cross-section cache)\n"
+         << "-ntuple 1/0 (optional, stream the secondaries)\n"
+         << "-eventfile hepmc3/binary/0 (optional, write the events)\n"
+         << "-library file (optional, only build a final-state library)\n"
+         << "-xs slab_cm (optional, only write cross-section tables and "
+            "sample the interaction depth in a slab)\n"
+         << "-profile 1/0 (optional, time per process and model)\n"
+         << "-eptolerance MeV (optional, 1, energy-momentum conservation)\n"
          << G4endl;
 }
 } // namespace CLIoutput
 
-int main(int argc, char **argv) {
+namespace rng {
+// Default run seed
+//
+const long defaultRunSeed = 123;
 
-  G4cout << "=== Using HadronicGenerator for final states sampling test, ==="
-         << G4endl
-         << "    this test is based on example Hadr09.                      "
-         << G4endl;
-  G4cout << "=== Using Geant4: " << G4VERSION_NUMBER << G4endl;
-  // See the HadronicGenerator class for the possibilities and meaning of the
-  // "physics cases". ( In short, it is the name of the Geant4 hadronic model
-  // used for the simulation of
-  //   the collision, with the possibility of having a transition between two
-  //   models in a given energy interval, as in physics lists. )
+// SplitMix64 finalizer: a bijective mix of a 64-bit word
+//
+inline std::uint64_t SplitMix64(std::uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
 
-  // Initial variables (physics list, particle, energy, material)
-  //
-  G4String namePhysics;
-  G4String nameProjectile;
-  G4double energyProjectile;
-  G4String nameMaterial;
-  G4bool saveRandomStatus = false;
-  G4bool redoEvent = false;
+// Seed the engine for an event from (run seed, event id) only, so that any
+// event range gives the same events on any thread or process as in a
+// serial run: key = SplitMix64(run seed) ^ event, then two more SplitMix64
+// steps give x1 = SplitMix64(key) and x2 = SplitMix64(x1), and the two
+// seeds are 1 + x % 2147483398, i.e. in [1, 2147483398], valid for
+// RanecuEngine (whose two seeds must be non-zero and below 2147483563 and
+// 2147483399).
+//
+inline void SeedEvent(CLHEP::HepRandomEngine &engine, long runSeed,
+                      std::uint64_t event) {
+  const std::uint64_t key =
+      SplitMix64(static_cast<std::uint64_t>(runSeed)) ^ event;
+  const std::uint64_t first = SplitMix64(key);
+  const std::uint64_t second = SplitMix64(first);
+  const long seeds[3] = {static_cast<long>(1 + first % 2147483398ULL),
+                         static_cast<long>(1 + second % 2147483398ULL), 0};
+  engine.setSeeds(seeds, -1);
+}
 
-  // CLI variables
-  //
-  if (argc == 1) {
-    CLIoutput::PrintError();
-    return 1;
+// Random engine of a thread: owned here and set as the engine of the
+// thread for the lifetime of the object, unset before it is deleted
+//
+class ThreadEngine {
+public:
+  ThreadEngine() : fEngine(new CLHEP::RanecuEngine()) {
+    CLHEP::HepRandom::setTheEngine(fEngine.get());
   }
-  for (G4int i = 1; i < argc; i = i + 2) {
-    if (G4String(argv[i]) == "-pl")
-      namePhysics = argv[i + 1];
-    else if (G4String(argv[i]) == "-p")
-      nameProjectile = argv[i + 1];
-    else if (G4String(argv[i]) == "-e")
-      energyProjectile = G4UIcommand::ConvertToDouble(argv[i + 1]);
-    else if (G4String(argv[i]) == "-m")
-      nameMaterial = argv[i + 1];
-    else if (G4String(argv[i]) == "-seed")
-      saveRandomStatus = G4UIcommand::ConvertToInt(argv[i + 1]);
-    else if (G4String(argv[i]) == "-redo")
-      redoEvent = G4UIcommand::ConvertToInt(argv[i + 1]);
-    else {
-      CLIoutput::PrintError();
-      return 1;
+  ~ThreadEngine() { CLHEP::HepRandom::setTheEngine(nullptr); }
+  ThreadEngine(const ThreadEngine &) = delete;
+  ThreadEngine &operator=(const ThreadEngine &) = delete;
+
+private:
+  std::unique_ptr<CLHEP::HepRandomEngine> fEngine;
+};
+} // namespace rng
+
+namespace mt {
+// Serialize the construction of the per-thread HadronicGenerator,
+// it touches the shared particle and ion tables
+//
+std::mutex initMutex;
+
+// Geant4 split classes (particle table and per-particle process managers)
+// need a worker copy before a HadronicGenerator can be built on a thread
+// other than the master one. This mirrors what G4WorkerThread does when a
+// run manager is available.
+//
+void InitializeWorkerThread(G4int threadId) {
+#ifdef G4MULTITHREADED
+  G4Threading::G4SetThreadId(threadId);
+  G4ParticleTable::GetParticleTable()->WorkerG4ParticleTable();
+  const_cast<G4PDefManager &>(G4ParticleDefinition::GetSubInstanceManager())
+      .NewSubInstances();
+#else
+  (void)threadId;
+#endif
+}
+
+// Reusable barrier for the master and the persistent workers: all of them
+// start and finish each scan point together
+//
+class Barrier {
+public:
+  explicit Barrier(G4int nThreads) : fThreads(nThreads) {}
+  void Wait() {
+    std::unique_lock<std::mutex> lock(fMutex);
+    const std::size_t generation = fGeneration;
+    if (++fWaiting == fThreads) {
+      fWaiting = 0;
+      fGeneration++;
+      fCondition.notify_all();
+    } else {
+      fCondition.wait(lock, [&] { return generation != fGeneration; });
     }
   }
 
-  // Check namePhysics is in physicslists
-  //
-  if (std::find(pl::list.begin(), pl::list.end(), namePhysics) ==
-      pl::list.end()) {
-    G4cerr << namePhysics << " is not in: " << G4endl;
-    for (auto &i : pl::list) {
-      G4cout << i << G4endl;
+private:
+  std::mutex fMutex;
+  std::condition_variable fCondition;
+  const G4int fThreads;
+  G4int fWaiting = 0;
+  std::size_t fGeneration = 0;
+};
+} // namespace mt
+
+namespace scan {
+// Split a comma-separated CLI value
+//
+std::vector<G4String> SplitList(const G4String &value) {
+  std::vector<G4String> items;
+  std::stringstream stream(value);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
     }
-    return 1;
   }
+  return items;
+}
 
-  // The HadronicGenerator from Hadr09 example
-  //
-  HadronicGenerator *theHadronicGenerator = new HadronicGenerator(namePhysics);
+// Parse energies (GeV): a comma-separated list of values and of ranges
+// min:max:logN or min:max:linN (N points, both ends included).
+// Returns an empty vector if the value is malformed.
+//
+std::vector<G4double> ParseEnergies(const G4String &value) {
+  std::vector<G4double> energies;
+  for (const G4String &item : SplitList(value)) {
+    const std::size_t first = item.find(':');
+    if (first == std::string::npos) {
+      energies.push_back(G4UIcommand::ConvertToDouble(item.c_str()));
+      continue;
+    }
+    const std::size_t second = item.find(':', first + 1);
+    if (second == std::string::npos) {
+      return {};
+    }
+    const G4String spacing = item.substr(second + 1, 3);
+    const G4double min =
+        G4UIcommand::ConvertToDouble(item.substr(0, first).c_str());
+    const G4double max = G4UIcommand::ConvertToDouble(
+        item.substr(first + 1, second - first - 1).c_str());
+    const G4int nPoints = std::atoi(item.substr(second + 4).c_str());
+    if ((spacing != "log" && spacing != "lin") || nPoints < 1 || min <= 0. ||
+        max < min) {
+      return {};
+    }
+    for (G4int i = 0; i < nPoints; i++) {
+      const G4double fraction =
+          nPoints == 1 ? 0. : static_cast<G4double>(i) / (nPoints - 1);
+      energies.push_back(spacing == "log"
+                             ? min * std::pow(max / min, fraction)
+                             : min + (max - min) * fraction);
+    }
+  }
+  return energies;
+}
 
-  // Set primary particle
-  //
-  G4ParticleTable *partTable = G4ParticleTable::GetParticleTable();
-  partTable->SetReadiness();
-  G4ParticleDefinition *projectile = partTable->FindParticle(nameProjectile);
-  G4ThreeVector aDirection = G4ThreeVector(0.0, 0.0, 1.0); // along z
-  G4double projectileEnergy = energyProjectile * CLHEP::GeV;
-  G4DynamicParticle dParticle(projectile, aDirection, projectileEnergy);
+// Parse the event ids to redo: a comma-separated list, or the name of a
+// file with ids separated by commas or white space. "0" alone keeps the
+// former meaning of -redo 0 (no redo). Returns an empty vector if the
+// value is malformed.
+//
+std::vector<std::size_t> ParseEvents(const G4String &value) {
+  if (value.empty() || value == "0") {
+    return {};
+  }
+  G4String list = value;
+  std::ifstream file(value);
+  if (file) {
+    std::ostringstream content;
+    content << file.rdbuf();
+    list = content.str();
+    std::replace_if(
+        list.begin(), list.end(),
+        [](char c) { return std::isspace(static_cast<unsigned char>(c)); },
+        ',');
+  }
+  std::vector<std::size_t> events;
+  for (const G4String &item : SplitList(list)) {
+    if (item.find_first_not_of("0123456789") != std::string::npos) {
+      return {};
+    }
+    events.push_back(std::stoull(item));
+  }
+  return events;
+}
 
-  // Set material, get nuclear mass and binding energy
-  //
-  G4Material *material =
-      G4NistManager::Instance()->FindOrBuildMaterial(nameMaterial);
-  G4NucleiProperties NucleiProperties;
-  const G4Element *element = material->GetElement(0);
-  G4double nuclearMass =
-      NucleiProperties.GetNuclearMass(element->GetN(), element->GetZ());
-  G4double bindingEnergy =
-      NucleiProperties.GetBindingEnergy(element->GetN(), element->GetZ());
-
-  // Create root output file
+// Label of an energy (GeV) in the output names: the first four characters,
+// as for a single energy, if they give back the energy, otherwise all its
+// significant digits, so that the points of a scan get distinct names
+//
+G4String EnergyLabel(G4double energy) {
+  const G4String label = std::to_string(energy).substr(0, 4);
+  if (G4UIcommand::ConvertToDouble(label.c_str()) == energy) {
+    return label;
+  }
+  std::ostringstream fullLabel;
+  fullLabel << std::setprecision(std::numeric_limits<G4double>::max_digits10)
+            << energy;
+  return fullLabel.str();
+}
+
+// One point of the scan
+//
+struct Point {
+  G4ParticleDefinition *projectile;
+  G4double energy; // GeV
+  G4Material *material;
+};
+} // namespace scan
+
+namespace shard {
+// Shard k (from 0) of N, of a run split over N jobs
+//
+struct Shard {
+  std::size_t index = 0;
+  std::size_t count = 1;
+};
+
+// Parse -shard k/N, returns false if malformed or k >= N
+//
+G4bool Parse(const G4String &value, Shard &shard) {
+  const std::size_t slash = value.find('/');
+  if (slash == std::string::npos || slash == 0 ||
+      slash + 1 == value.size() ||
+      value.find_first_not_of("0123456789/") != std::string::npos ||
+      value.find('/', slash + 1) != std::string::npos) {
+    return false;
+  }
+  shard.index = std::stoull(value.substr(0, slash));
+  shard.count = std::stoull(value.substr(slash + 1));
+  return shard.count > 0 && shard.index < shard.count;
+}
+
+// Sidecar JSON of a shard output, read by util/mergeshards.py
+//
+G4bool WriteMetadata(const G4String &fileName, const Shard &shard,
+                     const std::vector<std::pair<G4String, G4String>> &fields,
+                     std::size_t firstEvent, std::size_t lastEvent,
+                     long runSeed) {
+  std::ofstream file(fileName);
+  if (!file) {
+    G4cerr << "Cannot open " << fileName << G4endl;
+    return false;
+  }
+  file << "{\n  \"shard\": " << shard.index
+       << ",\n  \"shards\": " << shard.count
+       << ",\n  \"first_event\": " << firstEvent
+       << ",\n  \"last_event\": " << lastEvent
+       << ",\n  \"run_seed\": " << runSeed
+       << ",\n  \"geant4_version_number\": " << G4VERSION_NUMBER;
+  for (const auto &field : fields) {
+    file << ",\n  \"" << field.first << "\": \"" << field.second << "\"";
+  }
+  file << "\n}\n";
+  return true;
+}
+} // namespace shard
+
+namespace nuclei {
+// Nuclear mass and binding energy of a target nucleus
+//
+struct Nucleus {
+  G4int Z;
+  G4int A;
+  G4double mass;
+  G4double bindingEnergy;
+};
+
+// Nuclei of the isotopes of all the elements of a material, computed once
+// at startup, so that the event loop looks up the target nucleus sampled
+// by the process instead of calling G4NucleiProperties
+//
+class NucleiTable {
+public:
+  explicit NucleiTable(const G4Material *material) {
+    for (std::size_t e = 0; e < material->GetNumberOfElements(); e++) {
+      const G4Element *element = material->GetElement(e);
+      for (std::size_t i = 0; i < element->GetNumberOfIsotopes(); i++) {
+        const G4Isotope *isotope = element->GetIsotope(i);
+        const G4int Z = isotope->GetZ();
+        const G4int A = isotope->GetN();
+        if (Find(Z, A) == nullptr) {
+          fNuclei.push_back({Z, A, G4NucleiProperties::GetNuclearMass(A, Z),
+                             G4NucleiProperties::GetBindingEnergy(A, Z)});
+        }
+      }
+    }
+  }
+
+  // A few entries: linear search
   //
-  auto analysisManager = G4AnalysisManager::Instance();
-  G4String nameOutput = namePhysics + nameProjectile +
-                        std::to_string(energyProjectile).substr(0, 4) +
-                        nameMaterial + ".root";
-  analysisManager->OpenFile(nameOutput);
-  analysisManager->CreateH1("Momentum_conservation", "Momentum_conservation",
-                            2000, -0.02, 0.02);
-  analysisManager->CreateH1("Neutron_kenergy", "Neutron_kenergy", 1000, 0.0,
-                            1.1 * energyProjectile);
-  analysisManager->CreateH1("Pi0_energy", "Pi0_energy", 1000, 0.0,
-                            1.1 * energyProjectile);
-  analysisManager->CreateH1("E_loss", "E_loss", 500, -1.0,
-                            2.0 * bindingEnergy / CLHEP::GeV);
-  analysisManager->CreateH1("Pi-_Pz", "Pi-_Pz", 100, -1.2 * energyProjectile,
-                            1.2 * energyProjectile);
-  analysisManager->CreateH1("Pi-_Pz_wPt", "Pi-_Pz_wPt", 100,
-                            -1.2 * energyProjectile, 1.2 * energyProjectile);
-
-  CLHEP::HepRandom::setTheEngine(new CLHEP::RanecuEngine());
-  CLHEP::HepRandom::setTheSeed(123);
-
-  // Printout the configuration
+  const Nucleus *Find(G4int Z, G4int A) const {
+    for (const Nucleus &nucleus : fNuclei) {
+      if (nucleus.Z == Z && nucleus.A == A) {
+        return &nucleus;
+      }
+    }
+    return nullptr;
+  }
+
+  const std::vector<Nucleus> &GetNuclei() const { return fNuclei; }
+
+  G4double GetMaxBindingEnergy() const {
+    G4double maxBindingEnergy = 0.;
+    for (const Nucleus &nucleus : fNuclei) {
+      maxBindingEnergy = std::max(maxBindingEnergy, nucleus.bindingEnergy);
+    }
+    return maxBindingEnergy;
+  }
+
+private:
+  std::vector<Nucleus> fNuclei;
+};
+} // namespace nuclei
+
+namespace anomaly {
+// Per-event quantities: momentum conservation along z (GeV), its absolute
+// value, energy loss (GeV), energy loss over the binding energy of the
+// target nucleus, number of secondaries
+//
+enum class Quantity { Mom, AbsMom, ELoss, ELossOverB, NSecondaries };
+
+struct Values {
+  G4double mom;
+  G4double eLoss;
+  G4double eLossOverB; // NaN if the binding energy is not known
+  G4int nSecondaries;
+
+  G4double Get(Quantity quantity) const {
+    switch (quantity) {
+    case Quantity::Mom:
+      return mom;
+    case Quantity::AbsMom:
+      return std::abs(mom);
+    case Quantity::ELoss:
+      return eLoss;
+    case Quantity::ELossOverB:
+      return eLossOverB;
+    default:
+      return nSecondaries;
+    }
+  }
+};
+
+// quantity < threshold or quantity > threshold
+//
+struct Predicate {
+  Quantity quantity;
+  G4bool greater;
+  G4double threshold;
+  G4String text;
+};
+
+// Parse a comma-separated list of predicates, e.g. "absmom>0.01,eloss<0",
+// returns an empty vector if the value is malformed
+//
+std::vector<Predicate> Parse(const G4String &value) {
+  static const std::vector<std::pair<G4String, Quantity>> quantities{
+      {"mom", Quantity::Mom},
+      {"absmom", Quantity::AbsMom},
+      {"eloss", Quantity::ELoss},
+      {"elossoverb", Quantity::ELossOverB},
+      {"nsec", Quantity::NSecondaries}};
+  std::vector<Predicate> predicates;
+  for (const G4String &item : scan::SplitList(value)) {
+    const std::size_t op = item.find_first_of("<>");
+    if (op == std::string::npos || op + 1 == item.size()) {
+      return {};
+    }
+    auto quantity = std::find_if(
+        quantities.begin(), quantities.end(),
+        [&](const std::pair<G4String, Quantity> &entry) {
+          return entry.first == item.substr(0, op);
+        });
+    if (quantity == quantities.end()) {
+      return {};
+    }
+    predicates.push_back(
+        {quantity->second, item[op] == '>',
+         G4UIcommand::ConvertToDouble(item.substr(op + 1).c_str()), item});
+  }
+  return predicates;
+}
+
+// Index of the first predicate the event trips, -1 if none (comparisons
+// with NaN are false)
+//
+G4int Check(const std::vector<Predicate> &predicates, const Values &values) {
+  for (std::size_t i = 0; i < predicates.size(); i++) {
+    const G4double value = values.Get(predicates[i].quantity);
+    if (predicates[i].greater ? value > predicates[i].threshold
+                              : value < predicates[i].threshold) {
+      return static_cast<G4int>(i);
+    }
+  }
+  return -1;
+}
+
+// An event that tripped a predicate
+//
+struct Anomaly {
+  std::size_t event;
+  G4int predicate;
+  Values values;
+};
+} // namespace anomaly
+
+namespace evt {
+// Run settings shared (read-only) by all workers
+//
+struct RunSettings {
+  G4ParticleDefinition *projectile;
+  G4double projectileEnergy;
+  G4ThreeVector direction;
+  G4Material *material;
+  const nuclei::NucleiTable *nuclei; // of material
+  long runSeed; // the engine is seeded per event from runSeed and event id
+  SeedJournal *seedJournal; // null if the engine states are not used
+  // Events to redo, restored from seedJournal (if any) instead of recorded
+  // in it, null for a normal run
+  const std::vector<std::size_t> *redoEvents;
+  const EnergySpectrum *spectrum; // null for monoenergetic projectiles
+  EarlyStop *earlyStop; // null if every point runs all its events
+  EventWriter *eventWriter; // null if the events are not written
+  // Anomaly predicates, null if none: the engine state of the events that
+  // trip one is recorded in anomalyJournal (if not null)
+  const std::vector<anomaly::Predicate> *anomalyPredicates;
+  SeedJournal *anomalyJournal;
+  G4bool anomalySecondaries; // also keep the secondaries of the anomalies
+};
+
+// Per-event observables of the stopping rule
+//
+const std::vector<G4String> observables{"eloss", "neutron", "pi0"};
+
+// One secondary of a redone event, written to the redo CSV file
+//
+struct RedoRow {
+  std::size_t event;
+  G4int secondary;
+  G4int pdg;
+  G4String name;
+  G4double px, py, pz, e, ekin; // MeV
+  G4double mzConservation;      // GeV, of the event
+  G4double eLoss;               // GeV, of the event
+};
+
+void WriteRedoRows(const G4String &fileName,
+                   const std::vector<std::vector<RedoRow>> &threadRows) {
+  std::ofstream file(fileName);
+  if (!file) {
+    G4cerr << "cannot open " << fileName << G4endl;
+    return;
+  }
+  file << "event,secondary,pdg,particle,px_MeV,py_MeV,pz_MeV,e_MeV,ekin_MeV,"
+          "mz_conservation_GeV,e_loss_GeV\n";
+  file << std::setprecision(10);
+  for (const auto &rows : threadRows) {
+    for (const RedoRow &row : rows) {
+      file << row.event << ',' << row.secondary << ',' << row.pdg << ','
+           << row.name << ',' << row.px << ',' << row.py << ',' << row.pz
+           << ',' << row.e << ',' << row.ekin << ',' << row.mzConservation
+           << ',' << row.eLoss << '\n';
+    }
+  }
+}
+
+// Anomalies captured by a thread, with their secondaries if requested
+//
+struct AnomalyCapture {
+  std::vector<anomaly::Anomaly> anomalies;
+  std::vector<RedoRow> secondaries;
+};
+
+// Anomalies of all threads (event order, as the threads process contiguous
+// blocks): the event ids, usable with -redo, and a CSV of the event
+// quantities and tripped predicate
+//
+void WriteAnomalies(const G4String &stem,
+                    const std::vector<AnomalyCapture> &threadCaptures,
+                    const std::vector<anomaly::Predicate> &predicates) {
+  std::ofstream ids(stem + "_anomalies.txt");
+  std::ofstream file(stem + "_anomalies.csv");
+  if (!ids || !file) {
+    G4cerr << "cannot open " << stem << "_anomalies.txt/.csv" << G4endl;
+    return;
+  }
+  file << "event,predicate,mz_conservation_GeV,e_loss_GeV,e_loss_over_B,"
+          "secondaries\n";
+  file << std::setprecision(10);
+  std::size_t nAnomalies = 0;
+  for (const AnomalyCapture &capture : threadCaptures) {
+    for (const anomaly::Anomaly &entry : capture.anomalies) {
+      ids << entry.event << '\n';
+      file << entry.event << ',' << predicates[entry.predicate].text << ','
+           << entry.values.mom << ',' << entry.values.eLoss << ','
+           << entry.values.eLossOverB << ',' << entry.values.nSecondaries
+           << '\n';
+      nAnomalies++;
+    }
+  }
+  G4cout << "Anomalous events: " << nAnomalies << ", listed in " << stem
+         << "_anomalies.csv" << G4endl;
+}
+
+// Thread-local histograms, with the binning of the booked ones, filled
+// without locking and written into G4AnalysisManager once per point
+//
+struct Histograms {
+  std::vector<H1Accumulator> h1;
+  std::vector<H2Accumulator> h2;
+
+  void Add(const Histograms &other) {
+    for (std::size_t h = 0; h < h1.size(); h++) {
+      h1[h].Add(other.h1[h]);
+    }
+    for (std::size_t h = 0; h < h2.size(); h++) {
+      h2[h].Add(other.h2[h]);
+    }
+  }
+
+  // Returns false if any histogram could not be written
   //
-  G4cout << G4endl
-         << "=================  Configuration ==================" << G4endl
-         << "Model: " << namePhysics << G4endl
-         << "Projectile: " << projectile->GetParticleName() << G4endl
-         << "Ekin: " << projectileEnergy / CLHEP::GeV << " GeV" << G4endl
-         << "Etot: " << dParticle.GetTotalEnergy() / CLHEP::GeV << " GeV"
-         << G4endl << "Momentum: " << dParticle.GetTotalMomentum() / CLHEP::GeV
-         << " GeV" << G4endl << "Material: " << material->GetName() << G4endl
-         << "Nuclear Mass: " << nuclearMass / CLHEP::GeV << " GeV" << G4endl
-         << "Binding Energy: " << bindingEnergy / CLHEP::GeV << " GeV" << G4endl
-         << "===================================================" << G4endl
-         << G4endl;
+  G4bool WriteTo(G4AnalysisManager *analysisManager) const {
+    G4bool written = true;
+    for (std::size_t h = 0; h < h1.size(); h++) {
+      written = h1[h].WriteTo(*analysisManager->GetH1(h)) && written;
+    }
+    for (std::size_t h = 0; h < h2.size(); h++) {
+      written = h2[h].WriteTo(*analysisManager->GetH2(h)) && written;
+    }
+    return written;
+  }
+};
+
+// Book the histograms for a projectile energy (GeV, the maximum one for a
+// spectrum) and binding energy
+// (the largest of the target nuclei), or rebin the already booked ones, and
+// return empty thread-local histograms with the same binning.
+// E_loss_over_B is the energy loss over the binding energy of the target
+// nucleus of each event, Delta_* are the final - initial energy, momentum
+// (GeV), charge and baryon number of each event.
+//
+Histograms BookHistograms(G4AnalysisManager *analysisManager,
+                          G4double energyProjectile, G4double bindingEnergy,
+                          G4bool create) {
+  const G4double eLossMax = 2.0 * bindingEnergy / CLHEP::GeV;
+  if (create) {
+    analysisManager->CreateH1("Momentum_conservation", "Momentum_conservation",
+                              2000, -0.02, 0.02);
+    analysisManager->CreateH1("Neutron_kenergy", "Neutron_kenergy", 1000, 0.0,
+                              1.1 * energyProjectile);
+    analysisManager->CreateH1("Pi0_energy", "Pi0_energy", 1000, 0.0,
+                              1.1 * energyProjectile);
+    analysisManager->CreateH1("E_loss", "E_loss", 500, -1.0, eLossMax);
+    analysisManager->CreateH1("Pi-_Pz", "Pi-_Pz", 100, -1.2 * energyProjectile,
+                              1.2 * energyProjectile);
+    analysisManager->CreateH1("Pi-_Pz_wPt", "Pi-_Pz_wPt", 100,
+                              -1.2 * energyProjectile, 1.2 * energyProjectile);
+    analysisManager->CreateH1("E_loss_over_B", "E_loss_over_B", 500, -1.0,
+                              2.0);
+    analysisManager->CreateH1("Projectile_ekin", "Projectile_ekin", 1000, 0.0,
+                              1.1 * energyProjectile);
+    analysisManager->CreateH2("E_loss_vs_Ekin", "E_loss_vs_Ekin", 100, 0.0,
+                              1.1 * energyProjectile, 100, -1.0, eLossMax);
+    analysisManager->CreateH1("Delta_E", "Delta_E", 1000, -0.05, 0.05);
+    analysisManager->CreateH1("Delta_px", "Delta_px", 1000, -0.05, 0.05);
+    analysisManager->CreateH1("Delta_py", "Delta_py", 1000, -0.05, 0.05);
+    analysisManager->CreateH1("Delta_pz", "Delta_pz", 1000, -0.05, 0.05);
+    analysisManager->CreateH1("Delta_Q", "Delta_Q", 21, -10.5, 10.5);
+    analysisManager->CreateH1("Delta_B", "Delta_B", 21, -10.5, 10.5);
+  } else {
+    analysisManager->SetH1(1, 1000, 0.0, 1.1 * energyProjectile);
+    analysisManager->SetH1(2, 1000, 0.0, 1.1 * energyProjectile);
+    analysisManager->SetH1(3, 500, -1.0, eLossMax);
+    analysisManager->SetH1(4, 100, -1.2 * energyProjectile,
+                           1.2 * energyProjectile);
+    analysisManager->SetH1(5, 100, -1.2 * energyProjectile,
+                           1.2 * energyProjectile);
+    analysisManager->SetH1(7, 1000, 0.0, 1.1 * energyProjectile);
+    analysisManager->SetH2(0, 100, 0.0, 1.1 * energyProjectile, 100, -1.0,
+                           eLossMax);
+  }
+
+  Histograms histos;
+  histos.h1.emplace_back(2000, -0.02, 0.02);
+  histos.h1.emplace_back(1000, 0.0, 1.1 * energyProjectile);
+  histos.h1.emplace_back(1000, 0.0, 1.1 * energyProjectile);
+  histos.h1.emplace_back(500, -1.0, eLossMax);
+  histos.h1.emplace_back(100, -1.2 * energyProjectile, 1.2 * energyProjectile);
+  histos.h1.emplace_back(100, -1.2 * energyProjectile, 1.2 * energyProjectile);
+  histos.h1.emplace_back(500, -1.0, 2.0);
+  histos.h1.emplace_back(1000, 0.0, 1.1 * energyProjectile);
+  for (G4int component = 0; component < 4; component++) {
+    histos.h1.emplace_back(1000, -0.05, 0.05);
+  }
+  histos.h1.emplace_back(21, -10.5, 10.5);
+  histos.h1.emplace_back(21, -10.5, 10.5);
+  histos.h2.emplace_back(100, 0.0, 1.1 * energyProjectile, 100, -1.0,
+                         eLossMax);
+  return histos;
+}
+
+// Event loop of a thread over [firstEvent, lastEvent), filling
+// thread-local histograms and, if ntupleWriter is not null, streaming the
+// secondaries to it. When redoing, the range indexes the list of events to
+// redo and their secondaries are appended to redoRows.
+// With a stopping rule, the loop ends as soon as the rule is met.
+// The events that trip an anomaly predicate are appended to anomalies.
+// Conservation is checked for every event by checker.
+// Returns the number of events skipped because the physics case does not
+// cover the projectile at their energy.
+//
+std::size_t ProcessEvents(HadronicGenerator *theHadronicGenerator,
+                   const RunSettings &settings, G4int thread,
+                   std::size_t firstEvent, std::size_t lastEvent,
+                   Histograms &histos, NtupleWriter *ntupleWriter,
+                   std::vector<RedoRow> &redoRows,
+                   AnomalyCapture &anomalies, ConservationChecker &checker) {
+
+  SeedJournal *seedJournal = settings.seedJournal;
+  const G4bool redoEvent = settings.redoEvents != nullptr;
+  const G4bool saveRandomStatus = seedJournal != nullptr && !redoEvent;
+  G4double projectileEnergy = settings.projectileEnergy;
+  G4DynamicParticle dParticle(settings.projectile, settings.direction,
+                              projectileEnergy);
 
   // Variables of interest
   //
   G4VParticleChange *aChange = nullptr;
-  std::size_t startEvent = 0;
-  std::size_t events = 100000;
   G4int nsecondaries;
   G4double mz_conservation;
   G4double neutron_kenergy = 0.;
   G4double pizero_energy = 0.;
   G4double e_loss;
-
-  if (redoEvent) {
-    G4cout << "which event: " << G4endl;
-    std::cin >> startEvent;
-    events = startEvent + 1;
+  std::unique_ptr<NtupleBuffer> ntuple;
+  if (ntupleWriter != nullptr) {
+    ntuple.reset(new NtupleBuffer(ntupleWriter));
+  }
+  std::int16_t model = -1;
+  std::int16_t targetZ = 0;
+  std::int16_t targetA = 0;
+  EarlyStop *earlyStop = settings.earlyStop;
+  std::vector<Welford> stats(observables.size());
+  std::unique_ptr<EventBuffer> eventRecord;
+  if (settings.eventWriter != nullptr) {
+    eventRecord.reset(new EventBuffer(settings.eventWriter));
   }
+  std::size_t skipped = 0;
 
-  for (std::size_t i = startEvent; i < events; i++) {
+  for (std::size_t i = firstEvent; i < lastEvent; i++) {
 
-    if (saveRandomStatus && (redoEvent == false)) {
-      std::string fileName = "event_" + std::to_string(i) + "rndm.stat";
-      CLHEP::HepRandom::getTheEngine()->saveStatus(fileName.c_str());
+    if (earlyStop != nullptr && earlyStop->ShouldStop()) {
+      break;
     }
-    if (redoEvent) {
-      G4cout << "Redoing event: " << i << G4endl;
-      std::string fileName = "event_" + std::to_string(i) + "rndm.stat";
-      CLHEP::HepRandom::getTheEngine()->restoreStatus(fileName.c_str());
+
+    const std::size_t event = redoEvent ? (*settings.redoEvents)[i] : i;
+    rng::SeedEvent(*CLHEP::HepRandom::getTheEngine(), settings.runSeed, event);
+    if (saveRandomStatus) {
+      seedJournal->Record(event, *CLHEP::HepRandom::getTheEngine());
+    }
+    if (seedJournal != nullptr && redoEvent &&
+        !seedJournal->Restore(event, *CLHEP::HepRandom::getTheEngine())) {
+      // Not in the journal: keep the event, on the seed of its id
+      //
+      G4cout << "WARNING: event " << event << " seeded from its id" << G4endl;
+      rng::SeedEvent(*CLHEP::HepRandom::getTheEngine(), settings.runSeed,
+                     event);
+    }
+
+    // Kinetic energy drawn from the spectrum, after the engine state is
+    // recorded or restored, so that a redone event gets the same energy
+    //
+    if (settings.spectrum != nullptr) {
+      projectileEnergy = settings.spectrum->Sample();
+      dParticle.SetKineticEnergy(projectileEnergy);
     }
 
     aChange = theHadronicGenerator->GenerateInteraction(
-        projectile, projectileEnergy, aDirection, material);
+        settings.projectile, projectileEnergy, settings.direction,
+        settings.material);
+
+    // The physics case may not cover all the energies of a spectrum
+    //
+    if (aChange == nullptr) {
+      skipped++;
+      continue;
+    }
+
+    nsecondaries = aChange->GetNumberOfSecondaries();
+
+    // Target nucleus sampled by the process, and model of the interaction
+    // for the ntuple
+    //
+    const G4Nucleus *target =
+        theHadronicGenerator->GetHadronicProcess()->GetTargetNucleus();
+    targetZ = static_cast<std::int16_t>(target->GetZ_asInt());
+    targetA = static_cast<std::int16_t>(target->GetA_asInt());
+    const nuclei::Nucleus *nucleus = settings.nuclei->Find(targetZ, targetA);
+    if (ntuple != nullptr) {
+#if G4VERSION_NUMBER >= 1100
+      G4HadronicInteraction *interaction =
+          theHadronicGenerator->GetHadronicInteraction();
+      model = interaction == nullptr
+                  ? -1
+                  : ntuple->GetModelIndex(interaction,
+                                          interaction->GetModelName());
+#endif
+    }
 
-    nsecondaries = aChange ? aChange->GetNumberOfSecondaries() : 0;
+    // Initial state for the conservation check and the event record:
+    // projectile and target nucleus at rest
+    //
+    const G4double targetMass =
+        nucleus != nullptr
+            ? nucleus->mass
+            : G4NucleiProperties::GetNuclearMass(targetA, targetZ);
+    checker.BeginEvent(dParticle, targetZ, targetA, targetMass);
+    if (eventRecord != nullptr) {
+      const G4LorentzVector momentum = dParticle.Get4Momentum();
+      eventRecord->BeginEvent(event, settings.projectile->GetPDGEncoding(),
+                              momentum.px(), momentum.py(), momentum.pz(),
+                              momentum.e(), dParticle.GetMass(), targetZ,
+                              targetA, targetMass);
+    }
 
     // Initial momentum along z
     //
@@ -233,14 +848,34 @@ int main(int argc, char **argv) {
       // Get dynamic particle
       //
       auto particle = aChange->GetSecondary(j)->GetDynamicParticle();
+      checker.AddSecondary(*particle);
 
-      // Printout with redo command true
+      // Dump with redo command
       //
       if (redoEvent) {
-        G4cout << " particle: " << particle->GetDefinition()->GetParticleName()
-               << " momentum (MeV): " << particle->GetTotalMomentum()
-               << " energy (MeV): " << particle->GetTotalEnergy()
-               << " k energy (MeV): " << particle->GetKineticEnergy() << G4endl;
+        const G4LorentzVector momentum = particle->Get4Momentum();
+        redoRows.push_back({event, j,
+                            particle->GetDefinition()->GetPDGEncoding(),
+                            particle->GetDefinition()->GetParticleName(),
+                            momentum.px(), momentum.py(), momentum.pz(),
+                            momentum.e(), particle->GetKineticEnergy(), 0.,
+                            0.});
+      }
+
+      // Stream the secondary
+      //
+      if (ntuple != nullptr) {
+        const G4LorentzVector momentum = particle->Get4Momentum();
+        ntuple->Fill(event, particle->GetDefinition()->GetPDGEncoding(),
+                     momentum.px(), momentum.py(), momentum.pz(),
+                     momentum.e(), particle->GetKineticEnergy(), model,
+                     targetZ, targetA, projectileEnergy);
+      }
+      if (eventRecord != nullptr) {
+        const G4LorentzVector momentum = particle->Get4Momentum();
+        eventRecord->AddSecondary(particle->GetDefinition()->GetPDGEncoding(),
+                                  momentum.px(), momentum.py(), momentum.pz(),
+                                  momentum.e(), particle->GetMass());
       }
 
       // Compute momentum conservation along z,
@@ -274,32 +909,963 @@ int main(int argc, char **argv) {
       //
       if (particle->GetDefinition() == G4PionMinus::PionMinus()) {
 
-        analysisManager->FillH1(4, particle->Get4Momentum()[2] / CLHEP::GeV);
+        histos.h1[4].Fill(particle->Get4Momentum()[2] / CLHEP::GeV);
         G4double pt =
             std::sqrt(std::pow(particle->GetMomentum()[0] / CLHEP::GeV, 2) +
                       std::pow(particle->GetMomentum()[1] / CLHEP::GeV, 2));
-        analysisManager->FillH1(5, particle->Get4Momentum()[2] / CLHEP::GeV,
-                                pt);
+        histos.h1[5].Fill(particle->Get4Momentum()[2] / CLHEP::GeV, pt);
       }
     }
+    if (eventRecord != nullptr) {
+      eventRecord->EndEvent();
+    }
+
+    histos.h1[0].Fill(mz_conservation);
+    histos.h1[1].Fill(neutron_kenergy);
+    histos.h1[2].Fill(pizero_energy);
+    histos.h1[3].Fill(e_loss);
+    histos.h1[7].Fill(projectileEnergy / CLHEP::GeV);
+    if (nucleus != nullptr && nucleus->bindingEnergy > 0.) {
+      histos.h1[6].Fill(e_loss / (nucleus->bindingEnergy / CLHEP::GeV));
+    }
+    histos.h2[0].Fill(projectileEnergy / CLHEP::GeV, e_loss);
+    checker.AddLocalDeposit(aChange->GetLocalEnergyDeposit());
+    const ConservationChecker::Delta delta = checker.EndEvent();
+    histos.h1[8].Fill(delta.e / CLHEP::GeV);
+    histos.h1[9].Fill(delta.px / CLHEP::GeV);
+    histos.h1[10].Fill(delta.py / CLHEP::GeV);
+    histos.h1[11].Fill(delta.pz / CLHEP::GeV);
+    histos.h1[12].Fill(delta.charge);
+    histos.h1[13].Fill(delta.baryonNumber);
 
-    analysisManager->FillH1(0, mz_conservation);
-    analysisManager->FillH1(1, neutron_kenergy);
-    analysisManager->FillH1(2, pizero_energy);
-    analysisManager->FillH1(3, e_loss);
+    // Anomalies: the engine state at the start of the event only depends
+    // on the run seed and the event id, so it is not copied for every event
+    // but regenerated for the events that trip a predicate
+    //
+    if (settings.anomalyPredicates != nullptr) {
+      const anomaly::Values values{
+          mz_conservation, e_loss,
+          nucleus != nullptr && nucleus->bindingEnergy > 0.
+              ? e_loss / (nucleus->bindingEnergy / CLHEP::GeV)
+              : std::numeric_limits<G4double>::quiet_NaN(),
+          nsecondaries};
+      const G4int predicate =
+          anomaly::Check(*settings.anomalyPredicates, values);
+      if (predicate >= 0) {
+        anomalies.anomalies.push_back({event, predicate, values});
+        if (settings.anomalyJournal != nullptr) {
+          CLHEP::HepRandomEngine *engine = CLHEP::HepRandom::getTheEngine();
+          rng::SeedEvent(*engine, settings.runSeed, event);
+          settings.anomalyJournal->Record(event, *engine);
+        }
+        for (G4int j = 0; settings.anomalySecondaries && j < nsecondaries;
+             j++) {
+          auto particle = aChange->GetSecondary(j)->GetDynamicParticle();
+          const G4LorentzVector momentum = particle->Get4Momentum();
+          anomalies.secondaries.push_back(
+              {event, j, particle->GetDefinition()->GetPDGEncoding(),
+               particle->GetDefinition()->GetParticleName(), momentum.px(),
+               momentum.py(), momentum.pz(), momentum.e(),
+               particle->GetKineticEnergy(), mz_conservation, e_loss});
+        }
+      }
+    }
+    if (earlyStop != nullptr) {
+      stats[0].Add(e_loss);
+      stats[1].Add(neutron_kenergy);
+      stats[2].Add(pizero_energy);
+      if (stats[0].GetN() % EarlyStop::updateEvents == 0) {
+        earlyStop->Update(thread, stats);
+      }
+    }
     if (saveRandomStatus) {
-      G4cout << "event " << i << " e_loss " << e_loss << G4endl;
+      G4cout << "event " << event << " e_loss " << e_loss << G4endl;
+    }
+    if (redoEvent) {
+      for (std::size_t row = redoRows.size() - nsecondaries;
+           row < redoRows.size(); row++) {
+        redoRows[row].mzConservation = mz_conservation;
+        redoRows[row].eLoss = e_loss;
+      }
     }
 
     neutron_kenergy = 0.;
     pizero_energy = 0.;
     aChange = nullptr;
   }
+  if (earlyStop != nullptr) {
+    earlyStop->Update(thread, stats); // events since the last update
+  }
+  return skipped;
+}
+} // namespace evt
 
-  // Close and write output file
+namespace library {
+// Build a final-state library: nEvents interactions per point, seeded from
+// the run seed and the event id as in the event loop, binned by projectile,
+// energy and the target element sampled by the process. Serial, the
+// library is built once and replayed many times
+//
+G4bool Build(HadronicGenerator *theHadronicGenerator,
+             const std::vector<scan::Point> &points,
+             const std::map<const G4Material *, nuclei::NucleiTable> &nuclei,
+             long runSeed, std::size_t nEvents, const G4ThreeVector &direction,
+             const G4String &fileName, const G4String &metadata) {
+  FinalStateLibraryWriter writer;
+  std::size_t nInteractions = 0;
+  // Interactions are sampled in batches, their secondaries copied into
+  // flat columns reused from batch to batch
   //
-  analysisManager->Write();
-  analysisManager->CloseFile();
+  const std::size_t batchSize = 1000;
+  SecondariesBuffer secondaries;
+  secondaries.Reserve(batchSize, 100 * batchSize);
+  for (const scan::Point &point : points) {
+    const G4double energy = point.energy * CLHEP::GeV;
+    const G4int projectilePDG = point.projectile->GetPDGEncoding();
+    const G4double projectileMass = point.projectile->GetPDGMass();
+    const nuclei::NucleiTable &nucleiTable = nuclei.at(point.material);
+    for (std::size_t first = 0; first < nEvents; first += batchSize) {
+      const G4int nBatch =
+          static_cast<G4int>(std::min(batchSize, nEvents - first));
+      const G4int nSampled = theHadronicGenerator->GenerateInteractions(
+          point.projectile, energy, direction, point.material, nBatch,
+          secondaries, [&](G4int i) {
+            rng::SeedEvent(*CLHEP::HepRandom::getTheEngine(), runSeed,
+                           first + i);
+          });
+      const std::size_t *offsets = secondaries.GetOffsets();
+      for (G4int i = 0; i < nSampled; i++) {
+        const G4int targetZ = secondaries.GetTargetZ()[i];
+        const G4int targetA = secondaries.GetTargetA()[i];
+        const nuclei::Nucleus *nucleus = nucleiTable.Find(targetZ, targetA);
+        writer.BeginInteraction(
+            projectilePDG, energy, targetZ, projectileMass,
+            nucleus != nullptr
+                ? nucleus->mass
+                : G4NucleiProperties::GetNuclearMass(targetA, targetZ));
+        for (std::size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+          writer.AddSecondary(secondaries.GetPDG()[j], secondaries.GetPx()[j],
+                              secondaries.GetPy()[j], secondaries.GetPz()[j],
+                              secondaries.GetE()[j]);
+        }
+      }
+      nInteractions += nSampled;
+      if (nSampled < nBatch) {
+        break; // point not covered by the physics case
+      }
+    }
+  }
+  if (!writer.Write(fileName, metadata)) {
+    return false;
+  }
+  G4cout << "Final-state library: " << nInteractions << " interactions in "
+         << writer.GetNBins() << " bins written to " << fileName << G4endl;
+  return true;
+}
+} // namespace library
+
+namespace xs {
+// Write the inelastic cross sections of a projectile on a material, per
+// element (mb) and per volume (1/cm, with the interaction length in cm),
+// on a logarithmic energy grid, 1 MeV - 100 TeV, 10 points per decade
+//
+G4bool WriteTable(HadronicGenerator *theHadronicGenerator,
+                  G4ParticleDefinition *projectile, const G4Material *material,
+                  const G4String &fileName) {
+  std::vector<G4double> energies;
+  for (G4int i = 0; i <= 80; i++) {
+    energies.push_back(CLHEP::MeV * std::pow(10., i / 10.));
+  }
+  const std::size_t n = energies.size();
+  const std::size_t nElements = material->GetNumberOfElements();
+  std::vector<std::vector<G4double>> elementXS(nElements,
+                                               std::vector<G4double>(n));
+  std::vector<G4double> materialXS(n);
+  for (std::size_t e = 0; e < nElements; e++) {
+    if (!theHadronicGenerator->GetElementCrossSections(
+            projectile, material->GetElement(e)->GetZasInt(), energies.data(),
+            n, elementXS[e].data())) {
+      return false;
+    }
+  }
+  if (!theHadronicGenerator->GetMaterialCrossSections(
+          projectile, material, energies.data(), n, materialXS.data())) {
+    return false;
+  }
+  std::ofstream file(fileName);
+  file << "energy_GeV";
+  for (std::size_t e = 0; e < nElements; e++) {
+    file << ",sigma_" << material->GetElement(e)->GetSymbol() << "_mb";
+  }
+  file << ",Sigma_per_cm,lambda_cm\n" << std::setprecision(8);
+  for (std::size_t i = 0; i < n; i++) {
+    file << energies[i] / CLHEP::GeV;
+    for (std::size_t e = 0; e < nElements; e++) {
+      file << ',' << elementXS[e][i] / CLHEP::millibarn;
+    }
+    file << ',' << materialXS[i] * CLHEP::cm << ','
+         << (materialXS[i] > 0. ? 1. / (materialXS[i] * CLHEP::cm) : 0.)
+         << '\n';
+  }
+  return static_cast<G4bool>(file);
+}
+
+// Sample the depth of the first inelastic interaction in a slab of given
+// thickness for nEvents projectiles of the point (or of the spectrum): the
+// macroscopic cross sections of all the energies are queried in one call,
+// and the results are printed
+//
+G4bool SampleDepths(HadronicGenerator *theHadronicGenerator,
+                    const scan::Point &point, const EnergySpectrum *spectrum,
+                    std::size_t nEvents, G4double thickness, long runSeed) {
+  CLHEP::HepRandomEngine &engine = *CLHEP::HepRandom::getTheEngine();
+  rng::SeedEvent(engine, runSeed, 0);
+  std::vector<G4double> energies(nEvents, point.energy * CLHEP::GeV);
+  if (spectrum != nullptr) {
+    for (G4double &energy : energies) {
+      energy = spectrum->Sample();
+    }
+  }
+  std::vector<G4double> crossSections(nEvents);
+  if (!theHadronicGenerator->GetMaterialCrossSections(
+          point.projectile, point.material, energies.data(), nEvents,
+          crossSections.data())) {
+    return false;
+  }
+  std::size_t nInteractions = 0;
+  G4double sumDepth = 0.;
+  G4double sumProbability = 0.;
+  for (std::size_t i = 0; i < nEvents; i++) {
+    const G4double depth = -std::log(1. - engine.flat()) / crossSections[i];
+    if (depth < thickness) {
+      nInteractions++;
+      sumDepth += depth;
+    }
+    sumProbability += 1. - std::exp(-thickness * crossSections[i]);
+  }
+  const G4double fraction = static_cast<G4double>(nInteractions) / nEvents;
+  G4cout << "Slab: " << thickness / CLHEP::cm << " cm of "
+         << point.material->GetName() << ", "
+         << point.projectile->GetParticleName() << " ";
+  if (spectrum != nullptr) {
+    G4cout << "spectrum " << spectrum->GetLabel();
+  } else {
+    G4cout << point.energy << " GeV, interaction length "
+           << 1. / (crossSections[0] * CLHEP::cm) << " cm";
+  }
+  G4cout << G4endl << "  interaction probability: " << sumProbability / nEvents
+         << " (sampled " << fraction << " +- "
+         << std::sqrt(fraction * (1. - fraction) / nEvents) << ", "
+         << nInteractions << "/" << nEvents << ")" << G4endl
+         << "  mean depth of the interactions: "
+         << (nInteractions > 0 ? sumDepth / nInteractions / CLHEP::cm : 0.)
+         << " cm" << G4endl;
+  return true;
+}
+} // namespace xs
+
+int main(int argc, char **argv) {
+
+  G4cout << "=== Using HadronicGenerator for final states sampling test, ==="
+         << G4endl
+         << "    this test is based on example Hadr09.                      "
+         << G4endl;
+  G4cout << "=== Using Geant4: " << G4VERSION_NUMBER << G4endl;
+  // See the HadronicGenerator class for the possibilities and meaning of the
+  // "physics cases". ( In short, it is the name of the Geant4 hadronic model
+  // used for the simulation of
+  //   the collision, with the possibility of having a transition between two
+  //   models in a given energy interval, as in physics lists. )
+
+  // Initial variables (physics list, particle, energy, material)
+  //
+  G4String namePhysics;
+  G4String nameProjectile;
+  G4String energyProjectile;
+  G4String spectrumDescription;
+  G4String nameMaterial;
+  long runSeed = rng::defaultRunSeed;
+  G4bool saveRandomStatus = false;
+  G4String redoList;
+  G4String anomalyList;
+  G4bool anomalySecondaries = false;
+  G4int nThreads = 1;
+  shard::Shard runShard;
+  G4int nEventsPerPoint = 100000;
+  G4String precisionList;
+  G4double timeBudget = 0.;
+  G4String crossSectionCacheDir;
+  G4bool writeNtuple = false;
+  G4String eventFormat;
+  G4String libraryFile;
+  G4double slabThickness = 0.; // cm
+  G4bool profile = false;
+  G4double epTolerance = 1.; // MeV
+
+  // CLI variables
+  //
+  if (argc == 1) {
+    CLIoutput::PrintError();
+    return 1;
+  }
+  for (G4int i = 1; i < argc; i = i + 2) {
+    if (G4String(argv[i]) == "-pl")
+      namePhysics = argv[i + 1];
+    else if (G4String(argv[i]) == "-p")
+      nameProjectile = argv[i + 1];
+    else if (G4String(argv[i]) == "-e")
+      energyProjectile = argv[i + 1];
+    else if (G4String(argv[i]) == "-spectrum")
+      spectrumDescription = argv[i + 1];
+    else if (G4String(argv[i]) == "-m")
+      nameMaterial = argv[i + 1];
+    else if (G4String(argv[i]) == "-runseed")
+      runSeed = G4UIcommand::ConvertToInt(argv[i + 1]);
+    else if (G4String(argv[i]) == "-n")
+      nEventsPerPoint = G4UIcommand::ConvertToInt(argv[i + 1]);
+    else if (G4String(argv[i]) == "-precision")
+      precisionList = argv[i + 1];
+    else if (G4String(argv[i]) == "-time")
+      timeBudget = G4UIcommand::ConvertToDouble(argv[i + 1]);
+    else if (G4String(argv[i]) == "-seed")
+      saveRandomStatus = G4UIcommand::ConvertToInt(argv[i + 1]);
+    else if (G4String(argv[i]) == "-redo")
+      redoList = argv[i + 1];
+    else if (G4String(argv[i]) == "-anomaly")
+      anomalyList = argv[i + 1];
+    else if (G4String(argv[i]) == "-anomalysecondaries")
+      anomalySecondaries = G4UIcommand::ConvertToInt(argv[i + 1]);
+    else if (G4String(argv[i]) == "-t")
+      nThreads = G4UIcommand::ConvertToInt(argv[i + 1]);
+    else if (G4String(argv[i]) == "-shard") {
+      if (!shard::Parse(argv[i + 1], runShard)) {
+        CLIoutput::PrintError();
+        return 1;
+      }
+    }
+    else if (G4String(argv[i]) == "-xscache")
+      crossSectionCacheDir = argv[i + 1];
+    else if (G4String(argv[i]) == "-ntuple")
+      writeNtuple = G4UIcommand::ConvertToInt(argv[i + 1]);
+    else if (G4String(argv[i]) == "-eventfile")
+      eventFormat = argv[i + 1];
+    else if (G4String(argv[i]) == "-library")
+      libraryFile = argv[i + 1];
+    else if (G4String(argv[i]) == "-xs")
+      slabThickness = G4UIcommand::ConvertToDouble(argv[i + 1]);
+    else if (G4String(argv[i]) == "-profile")
+      profile = G4UIcommand::ConvertToInt(argv[i + 1]);
+    else if (G4String(argv[i]) == "-eptolerance")
+      epTolerance = G4UIcommand::ConvertToDouble(argv[i + 1]);
+    else {
+      CLIoutput::PrintError();
+      return 1;
+    }
+  }
+
+  // Check namePhysics is in physicslists
+  //
+  if (std::find(pl::list.begin(), pl::list.end(), namePhysics) ==
+      pl::list.end()) {
+    G4cerr << namePhysics << " is not in: " << G4endl;
+    for (auto &i : pl::list) {
+      G4cout << i << G4endl;
+    }
+    return 1;
+  }
+
+  // Check the events to redo
+  //
+  const std::vector<std::size_t> redoEvents = scan::ParseEvents(redoList);
+  const G4bool redoEvent = !redoEvents.empty();
+  if (!redoEvent && !redoList.empty() && redoList != "0") {
+    CLIoutput::PrintError();
+    return 1;
+  }
+
+  // Check the anomaly predicates
+  //
+  const std::vector<anomaly::Predicate> anomalyPredicates =
+      anomaly::Parse(anomalyList);
+  const G4bool captureAnomalies = !anomalyPredicates.empty();
+  if (!captureAnomalies && !anomalyList.empty() && anomalyList != "0") {
+    CLIoutput::PrintError();
+    return 1;
+  }
+  if (captureAnomalies && redoEvent) {
+    G4cerr << "-anomaly cannot be used with -redo" << G4endl;
+    return 1;
+  }
+
+  // Check the event record format
+  //
+  const G4bool writeEvents = !eventFormat.empty() && eventFormat != "0";
+  if (writeEvents && eventFormat != "hepmc3" && eventFormat != "binary") {
+    CLIoutput::PrintError();
+    return 1;
+  }
+  const EventWriter::Format eventWriterFormat =
+      eventFormat == "binary" ? EventWriter::Format::Binary
+                              : EventWriter::Format::HepMC3;
+
+  // Check number of threads
+  //
+  if (nThreads < 1) {
+    CLIoutput::PrintError();
+    return 1;
+  }
+#ifndef G4MULTITHREADED
+  if (nThreads > 1) {
+    G4cout << "Geant4 built without multi-threading, using 1 thread"
+           << G4endl;
+    nThreads = 1;
+  }
+#endif
+
+  // Check the number of events and the stopping rule: target relative
+  // errors on the mean of per-event observables and a wall-clock budget,
+  // not for shards (their event ranges must be complete) nor redo
+  //
+  if (nEventsPerPoint < 1 || timeBudget < 0. || epTolerance <= 0.) {
+    CLIoutput::PrintError();
+    return 1;
+  }
+  EarlyStop earlyStop(evt::observables, nThreads);
+  earlyStop.SetTimeBudget(timeBudget);
+  for (const G4String &item : scan::SplitList(precisionList)) {
+    const std::size_t colon = item.find(':');
+    const G4double target =
+        colon == std::string::npos
+            ? 0.
+            : G4UIcommand::ConvertToDouble(item.substr(colon + 1).c_str());
+    if (target <= 0. || !earlyStop.SetTarget(item.substr(0, colon), target)) {
+      CLIoutput::PrintError();
+      return 1;
+    }
+  }
+  if (earlyStop.IsActive() && (redoEvent || runShard.count > 1)) {
+    G4cerr << "-precision and -time cannot be used with -redo or -shard"
+           << G4endl;
+    return 1;
+  }
+  if (nThreads > 1) {
+    G4Threading::SetMultithreadedApplication(true);
+  }
+
+  // The HadronicGenerator from Hadr09 example
+  //
+  std::unique_ptr<HadronicGenerator> theHadronicGenerator(
+      new HadronicGenerator(namePhysics));
+  theHadronicGenerator->SetCrossSectionCacheDir(crossSectionCacheDir);
+
+  // Scan points: cartesian product of projectiles, energies and materials.
+  // All the materials are built first, so that their elements are known
+  // when the projectiles are set up (they key the cross-section cache)
+  //
+  G4ParticleTable *partTable = G4ParticleTable::GetParticleTable();
+  partTable->SetReadiness();
+  std::vector<G4ParticleDefinition *> projectiles;
+  for (const G4String &name : scan::SplitList(nameProjectile)) {
+    projectiles.push_back(partTable->FindParticle(name));
+    if (projectiles.back() == nullptr) {
+      G4cerr << name << " is not a particle" << G4endl;
+      return 1;
+    }
+  }
+  // Projectile energies: a spectrum is a single point, its maximum energy
+  // sets the histogram ranges
+  //
+  EnergySpectrum spectrum;
+  const G4bool useSpectrum = !spectrumDescription.empty();
+  if (useSpectrum &&
+      (!energyProjectile.empty() || !spectrum.Build(spectrumDescription))) {
+    CLIoutput::PrintError();
+    return 1;
+  }
+  const std::vector<G4double> energies =
+      useSpectrum ? std::vector<G4double>{spectrum.GetMaxEnergy() / CLHEP::GeV}
+                  : scan::ParseEnergies(energyProjectile);
+  std::vector<G4Material *> materials;
+  for (const G4String &name : scan::SplitList(nameMaterial)) {
+    materials.push_back(G4NistManager::Instance()->FindOrBuildMaterial(name));
+    if (materials.back() == nullptr) {
+      G4cerr << name << " is not a G4 material" << G4endl;
+      return 1;
+    }
+  }
+  std::map<const G4Material *, nuclei::NucleiTable> nucleiTables;
+  for (G4Material *material : materials) {
+    nucleiTables.emplace(material, nuclei::NucleiTable(material));
+  }
+  std::vector<scan::Point> points;
+  for (G4ParticleDefinition *projectile : projectiles) {
+    for (G4double energy : energies) {
+      for (G4Material *material : materials) {
+        points.push_back({projectile, energy, material});
+      }
+    }
+  }
+  if (points.empty()) {
+    CLIoutput::PrintError();
+    return 1;
+  }
+  if ((saveRandomStatus || redoEvent) && points.size() > 1) {
+    G4cerr << "-seed and -redo need a single projectile, energy and material"
+           << G4endl;
+    return 1;
+  }
+
+  // The cross-section cache holds the energies of the scan (none for a
+  // spectrum)
+  //
+  std::vector<G4double> crossSectionCacheEnergies;
+  if (!useSpectrum) {
+    for (G4double energy : energies) {
+      crossSectionCacheEnergies.push_back(energy * CLHEP::GeV);
+    }
+  }
+  theHadronicGenerator->SetCrossSectionCacheEnergies(crossSectionCacheEnergies);
+
+  // Set up only the hadronic processes (models and cross sections) needed by
+  // the projectiles, before the event loop
+  //
+  for (G4ParticleDefinition *projectile : projectiles) {
+    theHadronicGenerator->PrepareProjectile(projectile);
+  }
+
+  auto analysisManager = G4AnalysisManager::Instance();
+  rng::ThreadEngine masterEngine;
+  G4ThreeVector aDirection = G4ThreeVector(0.0, 0.0, 1.0); // along z
+
+  // Final-state library: built instead of the event loop, the energy of
+  // each point is a bin of the library
+  //
+  if (!libraryFile.empty()) {
+    if (useSpectrum || redoEvent || runShard.count > 1) {
+      G4cerr << "-library cannot be used with -spectrum, -redo or -shard"
+             << G4endl;
+      return 1;
+    }
+    std::ostringstream metadata;
+    metadata << "physics=" << namePhysics << " projectile=" << nameProjectile
+             << " energy_GeV=" << energyProjectile
+             << " material=" << nameMaterial << " seed=" << runSeed
+             << " events_per_point=" << nEventsPerPoint
+             << " geant4=" << G4VERSION_NUMBER;
+    return library::Build(theHadronicGenerator.get(), points, nucleiTables,
+                           runSeed, nEventsPerPoint, aDirection, libraryFile,
+                           metadata.str())
+               ? 0
+               : 1;
+  }
+
+  // Cross sections: tables per projectile and material, and interaction
+  // depth in a slab per point, instead of the event loop
+  //
+  if (slabThickness < 0.) {
+    CLIoutput::PrintError();
+    return 1;
+  }
+  if (slabThickness > 0.) {
+    if (redoEvent || runShard.count > 1) {
+      G4cerr << "-xs cannot be used with -redo or -shard" << G4endl;
+      return 1;
+    }
+    for (G4ParticleDefinition *projectile : projectiles) {
+      for (const G4Material *material : materials) {
+        const G4String nameTable = namePhysics +
+                                   projectile->GetParticleName() +
+                                   material->GetName() + "_xs.csv";
+        if (!xs::WriteTable(theHadronicGenerator.get(), projectile, material,
+                            nameTable)) {
+          G4cerr << "No inelastic cross section for "
+                 << projectile->GetParticleName() << G4endl;
+          return 1;
+        }
+        G4cout << "Cross sections written to " << nameTable << G4endl;
+      }
+    }
+    for (const scan::Point &point : points) {
+      xs::SampleDepths(theHadronicGenerator.get(), point,
+                       useSpectrum ? &spectrum : nullptr, nEventsPerPoint,
+                       slabThickness * CLHEP::cm, runSeed);
+    }
+    return 0;
+  }
+
+  std::size_t startEvent = 0;
+  std::size_t events = nEventsPerPoint;
+
+  // Redone events are indexed in their list
+  //
+  if (redoEvent) {
+    events = redoEvents.size();
+  }
+
+  // Shard k of N gets the contiguous block [N_events * k / N,
+  // N_events * (k + 1) / N) of the event range (or of the list of events to
+  // redo): events are seeded from their id, so the shards of a run give the
+  // same events as the full run
+  //
+  const G4bool sharded = runShard.count > 1;
+  if (sharded) {
+    const std::size_t allEvents = events - startEvent;
+    events = startEvent + allEvents * (runShard.index + 1) / runShard.count;
+    startEvent += allEvents * runShard.index / runShard.count;
+  }
+
+  // Static partition of the event range: worker t gets a contiguous block.
+  // Events are seeded from their id, so they do not depend on the partition
+  //
+  const std::size_t nEvents = events - startEvent;
+  auto firstEvent = [&](G4int t) {
+    return startEvent + nEvents * t / nThreads;
+  };
+
+  // Output files of a point are named after it
+  //
+  auto outputStem = [&](const scan::Point &point) {
+    return namePhysics + point.projectile->GetParticleName() +
+           (useSpectrum ? spectrum.GetLabel()
+                        : scan::EnergyLabel(point.energy)) +
+           point.material->GetName() +
+           (sharded ? "_shard" + std::to_string(runShard.index) + "of" +
+                          std::to_string(runShard.count)
+                    : "");
+  };
+  // Two points with the same name would overwrite each other's outputs
+  // (e.g. a projectile, energy or material given twice)
+  //
+  std::set<G4String> stems;
+  for (const scan::Point &point : points) {
+    if (!stems.insert(outputStem(point)).second) {
+      G4cerr << "Two points of the scan write to " << outputStem(point)
+             << ", remove the duplicate projectile, energy or material"
+             << G4endl;
+      return 1;
+    }
+  }
+
+  // Shared state of the current point, written by the master between two
+  // barriers and only read by the workers
+  //
+  evt::RunSettings settings{nullptr,
+                            0.,
+                            aDirection,
+                            nullptr,
+                            nullptr,
+                            runSeed,
+                            nullptr,
+                            redoEvent ? &redoEvents : nullptr,
+                            useSpectrum ? &spectrum : nullptr,
+                            earlyStop.IsActive() ? &earlyStop : nullptr,
+                            nullptr,
+                            captureAnomalies ? &anomalyPredicates : nullptr,
+                            nullptr,
+                            anomalySecondaries};
+  std::vector<evt::Histograms> threadHistos;
+  std::vector<std::vector<evt::RedoRow>> threadRedoRows(nThreads);
+  std::vector<evt::AnomalyCapture> threadAnomalies(nThreads);
+  std::vector<std::size_t> threadSkipped(nThreads); // events not covered
+  std::vector<ConservationChecker> checkers(
+      nThreads, ConservationChecker(epTolerance * CLHEP::MeV,
+                                    epTolerance * CLHEP::MeV));
+  SeedJournal anomalyJournal;
+  NtupleWriter ntupleWriter;
+  NtupleWriter *pointNtuple = nullptr; // null if no ntuple for the point
+  EventWriter eventWriter;
+  std::vector<InteractionProfiler> profilers(nThreads); // one per thread
+  if (profile) {
+    theHadronicGenerator->SetProfiler(&profilers[0]);
+  }
+  G4bool scanDone = false;
+
+  // Engine state of each event: one journal next to the output file,
+  // written with -seed 1 and read back when redoing (single point) if it
+  // exists and is readable, otherwise the redone events are seeded from
+  // their id. A list of anomalies (<stem>_anomalies.txt) is redone from the
+  // journal written with it (<stem>_anomalies_seeds.bin)
+  //
+  SeedJournal seedJournal;
+  const G4String anomalyListSuffix = "_anomalies.txt";
+  const G4bool redoAnomalies =
+      redoList.size() > anomalyListSuffix.size() &&
+      redoList.compare(redoList.size() - anomalyListSuffix.size(),
+                       anomalyListSuffix.size(), anomalyListSuffix) == 0;
+  const G4String nameJournal =
+      redoAnomalies ? redoList.substr(0, redoList.size() - 4) + "_seeds.bin"
+                    : outputStem(points[0]) + "_seeds.bin";
+  if (redoEvent && std::ifstream(nameJournal).good()) {
+    if (seedJournal.OpenForReading(nameJournal)) {
+      settings.seedJournal = &seedJournal;
+    } else {
+      G4cout << "WARNING: " << nameJournal
+             << " not readable, events seeded from their id" << G4endl;
+    }
+  }
+
+  // Persistent workers: each one builds its HadronicGenerator once and then
+  // processes its slice of every point of the scan
+  //
+  mt::Barrier barrier(nThreads);
+  std::vector<std::thread> workers;
+  for (G4int t = 1; t < nThreads; t++) {
+    workers.emplace_back([&, t]() {
+      std::unique_ptr<HadronicGenerator> workerGenerator;
+      {
+        std::lock_guard<std::mutex> lock(mt::initMutex);
+        mt::InitializeWorkerThread(t - 1);
+        workerGenerator.reset(new HadronicGenerator(namePhysics));
+        workerGenerator->SetCrossSectionCacheDir(crossSectionCacheDir);
+        workerGenerator->SetCrossSectionCacheEnergies(
+            crossSectionCacheEnergies);
+        if (profile) {
+          workerGenerator->SetProfiler(&profilers[t]);
+        }
+        for (G4ParticleDefinition *projectile : projectiles) {
+          workerGenerator->PrepareProjectile(projectile);
+        }
+      }
+      rng::ThreadEngine workerEngine;
+      while (true) {
+        barrier.Wait(); // point ready
+        if (scanDone) {
+          break;
+        }
+        threadSkipped[t] = evt::ProcessEvents(
+            workerGenerator.get(), settings, t, firstEvent(t),
+            firstEvent(t + 1), threadHistos[t], pointNtuple,
+            threadRedoRows[t], threadAnomalies[t], checkers[t]);
+        barrier.Wait(); // point done
+      }
+    });
+  }
+
+  for (std::size_t p = 0; p < points.size(); p++) {
+    const scan::Point &point = points[p];
+    const G4double energyProjectile = point.energy;
+    G4ParticleDefinition *projectile = point.projectile;
+    G4Material *material = point.material;
+    G4double projectileEnergy = energyProjectile * CLHEP::GeV;
+    G4DynamicParticle dParticle(projectile, aDirection, projectileEnergy);
+
+    // Nuclear masses and binding energies of the target nuclei
+    //
+    const nuclei::NucleiTable &nucleiTable = nucleiTables.at(material);
+    const G4double bindingEnergy = nucleiTable.GetMaxBindingEnergy();
+
+    // Create root output file, one per point: the histograms are booked
+    // once and rebinned for the following points
+    //
+    const G4String stemOutput = outputStem(point);
+    G4String nameOutput = stemOutput + ".root";
+    analysisManager->OpenFile(nameOutput);
+    std::ostringstream metadata;
+    metadata << "physics=" << namePhysics
+             << " projectile=" << projectile->GetParticleName();
+    if (useSpectrum) {
+      metadata << " spectrum=" << spectrumDescription;
+    } else {
+      metadata << " energy_GeV=" << energyProjectile;
+    }
+    metadata << " material=" << material->GetName()
+             << " threads=" << nThreads << " seed=" << runSeed;
+    if (sharded) {
+      metadata << " shard=" << runShard.index << "/" << runShard.count
+               << " events=" << startEvent << ":" << events;
+    }
+    if (writeNtuple) {
+      const G4String nameNtuple = stemOutput + "_ntuple.bin";
+      pointNtuple = ntupleWriter.Open(nameNtuple, metadata.str())
+                        ? &ntupleWriter
+                        : nullptr;
+    }
+    const G4String nameEvents =
+        stemOutput + (eventWriterFormat == EventWriter::Format::Binary
+                          ? "_events.bin"
+                          : "_events.hepmc3");
+    if (writeEvents) {
+      settings.eventWriter =
+          eventWriter.Open(nameEvents, eventWriterFormat, metadata.str())
+              ? &eventWriter
+              : nullptr;
+    }
+    if (saveRandomStatus && !redoEvent) {
+      settings.seedJournal =
+          seedJournal.OpenForWriting(stemOutput + "_seeds.bin",
+                                     *CLHEP::HepRandom::getTheEngine())
+              ? &seedJournal
+              : nullptr;
+    }
+    if (captureAnomalies) {
+      settings.anomalyJournal =
+          anomalyJournal.OpenForWriting(stemOutput + "_anomalies_seeds.bin",
+                                        *CLHEP::HepRandom::getTheEngine())
+              ? &anomalyJournal
+              : nullptr;
+    }
+    const evt::Histograms booked = evt::BookHistograms(
+        analysisManager, energyProjectile, bindingEnergy, p == 0);
+
+    settings.projectile = projectile;
+    settings.projectileEnergy = projectileEnergy;
+    settings.material = material;
+    settings.nuclei = &nucleiTable;
+
+    // Printout the configuration
+    //
+    G4cout << G4endl
+           << "=================  Configuration ==================" << G4endl
+           << "Point: " << p + 1 << "/" << points.size() << G4endl
+           << "Model: " << namePhysics << G4endl
+           << "Projectile: " << projectile->GetParticleName() << G4endl;
+    if (useSpectrum) {
+      G4cout << "Spectrum: " << spectrumDescription << " ("
+             << spectrum.GetMinEnergy() / CLHEP::GeV << " - "
+             << spectrum.GetMaxEnergy() / CLHEP::GeV << " GeV)" << G4endl;
+    } else {
+      G4cout << "Ekin: " << projectileEnergy / CLHEP::GeV << " GeV" << G4endl
+             << "Etot: " << dParticle.GetTotalEnergy() / CLHEP::GeV << " GeV"
+             << G4endl << "Momentum: "
+             << dParticle.GetTotalMomentum() / CLHEP::GeV << " GeV" << G4endl;
+    }
+    G4cout << "Material: " << material->GetName() << G4endl;
+    for (const nuclei::Nucleus &nucleus : nucleiTable.GetNuclei()) {
+      G4cout << "Nucleus Z=" << nucleus.Z << " A=" << nucleus.A
+             << " Nuclear Mass: " << nucleus.mass / CLHEP::GeV
+             << " GeV Binding Energy: " << nucleus.bindingEnergy / CLHEP::GeV
+             << " GeV" << G4endl;
+    }
+    G4cout << "Threads: " << nThreads << G4endl
+           << "===================================================" << G4endl
+           << G4endl;
+    if (p == 0) {
+      theHadronicGenerator->PrintInitTimes();
+    }
+
+    // Thread-local histograms, one set per worker, merged at the end
+    //
+    threadHistos.assign(nThreads, booked);
+
+    if (settings.earlyStop != nullptr) {
+      earlyStop.Start();
+    }
+
+    barrier.Wait(); // point ready
+    threadSkipped[0] = evt::ProcessEvents(
+        theHadronicGenerator.get(), settings, 0, firstEvent(0), firstEvent(1),
+        threadHistos[0], pointNtuple, threadRedoRows[0], threadAnomalies[0],
+        checkers[0]);
+    barrier.Wait(); // point done
+    if (settings.earlyStop != nullptr) {
+      earlyStop.Print();
+    }
+
+    // Merge thread-local histograms (in thread order) and write them into
+    // the output ones
+    //
+    for (G4int t = 1; t < nThreads; t++) {
+      threadHistos[0].Add(threadHistos[t]);
+    }
+    if (!threadHistos[0].WriteTo(analysisManager)) {
+      G4cerr << "WARNING: histograms of " << nameOutput
+             << " not written completely" << G4endl;
+    }
+
+    // Close and write output file
+    //
+    analysisManager->Write();
+    analysisManager->CloseFile();
+    ntupleWriter.Close();
+    eventWriter.Close();
+    seedJournal.Close();
+    anomalyJournal.Close();
+
+    // Shard metadata, next to the outputs
+    //
+    if (sharded) {
+      shard::WriteMetadata(
+          stemOutput + ".json", runShard,
+          {{"stem", stemOutput},
+           {"geant4_version", G4Version},
+           {"physics", namePhysics},
+           {"projectile", projectile->GetParticleName()},
+           {"energy",
+            useSpectrum ? spectrumDescription
+                        : G4String(std::to_string(energyProjectile))},
+           {"material", material->GetName()},
+           {"root", nameOutput},
+           {"ntuple", pointNtuple != nullptr ? stemOutput + "_ntuple.bin"
+                                             : G4String()},
+           {"events",
+            settings.eventWriter != nullptr ? nameEvents : G4String()}},
+          startEvent, events, runSeed);
+    }
+
+    // Events not covered by the physics case (projectile energy outside
+    // its applicability), a whole point of them gives empty histograms
+    //
+    std::size_t skipped = 0;
+    for (G4int t = 0; t < nThreads; t++) {
+      skipped += threadSkipped[t];
+      threadSkipped[t] = 0;
+    }
+    G4cout << (skipped > 0 ? "WARNING: " : "")
+           << "Events skipped (not covered by " << namePhysics
+           << "): " << skipped << G4endl;
+
+    // Conservation checks, merged over the threads
+    //
+    for (G4int t = 1; t < nThreads; t++) {
+      checkers[0].Merge(checkers[t]);
+      checkers[t].Clear();
+    }
+    checkers[0].Print();
+    checkers[0].Clear();
+
+    // Time per process and selected model, merged over the threads
+    //
+    if (profile) {
+      for (G4int t = 1; t < nThreads; t++) {
+        profilers[0].Merge(profilers[t]);
+        profilers[t].Clear();
+      }
+      profilers[0].Print();
+      profilers[0].WriteJSON(stemOutput + "_profile.json");
+      profilers[0].Clear();
+    }
+
+    // Anomalous events, their secondaries in the format of the redo ones
+    //
+    if (captureAnomalies) {
+      evt::WriteAnomalies(stemOutput, threadAnomalies, anomalyPredicates);
+      if (anomalySecondaries) {
+        std::vector<std::vector<evt::RedoRow>> rows;
+        for (evt::AnomalyCapture &capture : threadAnomalies) {
+          rows.push_back(std::move(capture.secondaries));
+        }
+        evt::WriteRedoRows(stemOutput + "_anomalies_secondaries.csv", rows);
+      }
+      for (evt::AnomalyCapture &capture : threadAnomalies) {
+        capture.anomalies.clear();
+        capture.secondaries.clear();
+      }
+    }
+
+    // Secondaries of the redone events, in the order of the list
+    //
+    if (redoEvent) {
+      evt::WriteRedoRows(stemOutput + "_redo.csv", threadRedoRows);
+      G4cout << "Redone events: " << redoEvents.size() << ", secondaries in "
+             << stemOutput + "_redo.csv" << G4endl;
+    }
+  }
+
+  scanDone = true;
+  barrier.Wait(); // release the workers
+  for (auto &worker : workers) {
+    worker.join();
+  }
   G4cout << "The end." << G4endl;
 }
 
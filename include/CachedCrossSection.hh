@@ -0,0 +1,121 @@
+//**************************************************
+// \file CachedCrossSection.hh
+// \brief: Definition of CachedCrossSection class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Cross-section dataset wrapping another one, for a single projectile.
+// The per-element inelastic cross sections of the wrapped dataset are
+// computed at the exact kinetic energies the run will ask for (the scan
+// energies), for all the elements defined so far, and written to a binary
+// file in the cache directory. The file is keyed by Geant4 version,
+// physics case, projectile, dataset, element list and energies: a later
+// run with the same key memory-maps the file and skips the
+// BuildPhysicsTable() of the wrapped dataset, any other run rebuilds it
+// and rewrites the file.
+// The cached values are the ones the wrapped dataset returns for the same
+// energy, and any other energy, element or isotope-level call is
+// forwarded to the wrapped dataset (built on first use), so that a run
+// gives the same events with or without the cache. The isotope-level
+// calls (isotope sampling in multi-isotope elements) need the wrapped
+// dataset, whose physics table is then built on the first of them: the
+// cache only saves the build of the element-level tables.
+
+#ifndef CachedCrossSection_h
+#define CachedCrossSection_h 1
+
+#include "G4VCrossSectionDataSet.hh"
+#include "G4Version.hh"
+#include "globals.hh"
+#include <cstdint>
+#include <vector>
+
+class G4DynamicParticle;
+class G4Element;
+class G4Isotope;
+class G4Material;
+class G4ParticleDefinition;
+
+class CachedCrossSection : public G4VCrossSectionDataSet {
+public:
+  CachedCrossSection(G4VCrossSectionDataSet *dataSet, const G4String &cacheDir,
+                     const G4String &physicsCase,
+                     const std::vector<G4double> &energies);
+  ~CachedCrossSection() override;
+
+  // Loads the table from the cache, or builds the wrapped dataset and
+  // writes the table to the cache
+  //
+  void BuildPhysicsTable(const G4ParticleDefinition &particle) override;
+
+  G4bool IsElementApplicable(const G4DynamicParticle *particle, G4int Z,
+                             const G4Material *material = nullptr) override;
+  G4double
+  GetElementCrossSection(const G4DynamicParticle *particle, G4int Z,
+                         const G4Material *material = nullptr) override;
+#if G4VERSION_NUMBER >= 1060
+  G4double ComputeCrossSectionPerElement(G4double kinEnergy, G4double logE,
+                                         const G4ParticleDefinition *particle,
+                                         const G4Element *element,
+                                         const G4Material *material) override;
+  G4double ComputeIsoCrossSection(G4double kinEnergy, G4double logE,
+                                  const G4ParticleDefinition *particle,
+                                  G4int Z, G4int A, const G4Isotope *isotope,
+                                  const G4Element *element,
+                                  const G4Material *material) override;
+#endif
+
+  // Isotope level: always the wrapped dataset
+  //
+  G4bool IsIsoApplicable(const G4DynamicParticle *particle, G4int Z, G4int A,
+                         const G4Element *element,
+                         const G4Material *material) override;
+  G4double GetIsoCrossSection(const G4DynamicParticle *particle, G4int Z,
+                              G4int A, const G4Isotope *isotope,
+                              const G4Element *element,
+                              const G4Material *material) override;
+  const G4Isotope *SelectIsotope(const G4Element *element,
+                                 G4double kinEnergy, G4double logE) override;
+
+  // True if the table comes from the cache file
+  //
+  G4bool IsLoadedFromCache() const { return fMapped != nullptr; }
+
+private:
+  G4String BuildKey() const;
+  G4String GetFileName(const G4String &key) const;
+  G4bool Load(const G4String &fileName, const G4String &key);
+  void Tabulate();
+  void Write(const G4String &fileName, const G4String &key) const;
+  void BuildDataSet();
+
+  // Table entry of (Z, kinEnergy), -1 if the energy or element is not
+  // tabulated (exact match of the energy)
+  //
+  G4int FindEntry(G4int Z, G4double kinEnergy) const;
+
+  G4VCrossSectionDataSet *fDataSet;
+  const G4ParticleDefinition *fParticle;
+  G4bool fDataSetBuilt;
+  G4String fCacheDir;
+  G4String fPhysicsCase;
+  std::vector<G4double> fEnergies; // sorted, unique
+
+  std::vector<G4int> fZ;                    // tabulated elements
+  std::vector<const G4Element *> fElements; // first element of each Z
+  std::vector<G4double> fLogEnergies;       // G4Log of fEnergies
+  std::vector<G4int> fTableIndex; // indexed by Z, -1 if not tabulated
+  std::vector<std::int32_t> fApplicableTable; // if not memory-mapped
+  std::vector<G4double> fTable;               // if not memory-mapped
+  const std::int32_t *fApplicable; // nElements x nEnergies, 1 or 0
+  const G4double *fXS;             // nTables x nElements x nEnergies
+
+  void *fMapped;
+  std::size_t fMappedSize;
+};
+
+#endif // CachedCrossSection_h
+
+//**************************************************
@@ -0,0 +1,120 @@
+//**************************************************
+// \file ConservationChecker.hh
+// \brief: Definition of ConservationChecker class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Energy, momentum, charge and baryon-number conservation of a final
+// state: the initial state is the projectile plus the sampled target
+// nucleus at rest, the final state is the list of secondaries (including
+// the residual nucleus and the nuclear fragments) plus the energy deposited
+// locally by the process.
+// The sums are accumulated in the loop over the secondaries that the
+// caller already does (one pass, a few additions per secondary), and the
+// differences final - initial are checked at the end of the event, with
+// absolute tolerances on energy and momentum; charge and baryon number
+// must be conserved exactly.
+// A checker is filled by a single thread, the checkers of several threads
+// are merged at the end.
+
+#ifndef ConservationChecker_h
+#define ConservationChecker_h 1
+
+#include "G4DynamicParticle.hh"
+#include "G4LorentzVector.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+#include <cmath>
+#include <cstdint>
+
+class ConservationChecker {
+public:
+  // Final - initial state of an event
+  //
+  struct Delta {
+    G4double e, px, py, pz; // MeV
+    G4int charge;           // units of eplus
+    G4int baryonNumber;
+  };
+
+  explicit ConservationChecker(G4double energyTolerance = 1. * CLHEP::MeV,
+                               G4double momentumTolerance = 1. * CLHEP::MeV)
+      : fEnergyTolerance(energyTolerance),
+        fMomentumTolerance(momentumTolerance) {}
+
+  // Start an event: projectile and target nucleus (Z, A) at rest
+  //
+  inline void BeginEvent(const G4DynamicParticle &projectile, G4int targetZ,
+                         G4int targetA, G4double targetMass);
+
+  inline void AddSecondary(const G4DynamicParticle &secondary);
+
+  // Energy deposited locally by the process (G4VParticleChange), part of
+  // the final state as in G4HadronicProcess::CheckEnergyMomentumConservation
+  // (the non-ionizing deposit is a part of it, not added again)
+  //
+  void AddLocalDeposit(G4double energy) { fE += energy; }
+
+  // Differences of the event, counted as violations beyond the tolerances
+  //
+  Delta EndEvent();
+
+  void Merge(const ConservationChecker &other);
+  void Clear();
+  void Print() const;
+
+private:
+  G4double fEnergyTolerance;
+  G4double fMomentumTolerance;
+
+  // Sums of the current event: initial state with a minus sign
+  //
+  G4double fE = 0.;
+  G4double fPx = 0.;
+  G4double fPy = 0.;
+  G4double fPz = 0.;
+  G4double fCharge = 0.;
+  G4int fBaryonNumber = 0;
+
+  // Counters over the events
+  //
+  std::uint64_t fEvents = 0;
+  std::uint64_t fEnergyViolations = 0;
+  std::uint64_t fMomentumViolations = 0;
+  std::uint64_t fChargeViolations = 0;
+  std::uint64_t fBaryonViolations = 0;
+  G4double fMaxEnergyDelta = 0.;   // absolute value
+  G4double fMaxMomentumDelta = 0.; // magnitude of the 3-vector
+};
+
+inline void ConservationChecker::BeginEvent(const G4DynamicParticle &projectile,
+                                            G4int targetZ, G4int targetA,
+                                            G4double targetMass) {
+  const G4ParticleDefinition *definition = projectile.GetDefinition();
+  const G4LorentzVector momentum = projectile.Get4Momentum();
+  fE = -momentum.e() - targetMass;
+  fPx = -momentum.px();
+  fPy = -momentum.py();
+  fPz = -momentum.pz();
+  fCharge = -definition->GetPDGCharge() / CLHEP::eplus - targetZ;
+  fBaryonNumber = -definition->GetBaryonNumber() - targetA;
+}
+
+inline void
+ConservationChecker::AddSecondary(const G4DynamicParticle &secondary) {
+  const G4ParticleDefinition *definition = secondary.GetDefinition();
+  const G4LorentzVector momentum = secondary.Get4Momentum();
+  fE += momentum.e();
+  fPx += momentum.px();
+  fPy += momentum.py();
+  fPz += momentum.pz();
+  fCharge += definition->GetPDGCharge() / CLHEP::eplus;
+  fBaryonNumber += definition->GetBaryonNumber();
+}
+
+#endif // ConservationChecker_h
+
+//**************************************************
@@ -0,0 +1,64 @@
+//**************************************************
+// \file CrossSectionTable.hh
+// \brief: Definition of CrossSectionTable class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Values (e.g. a cross section) tabulated on a logarithmic kinetic energy
+// grid, linearly interpolated in log energy. The batch evaluation has no
+// branch in its loop (the grid index is clamped with min/max) and reads
+// a contiguous array, so that large batches of energies are evaluated
+// with vectorizable loops. Energies outside the grid get the value of the
+// nearest end.
+
+#ifndef CrossSectionTable_h
+#define CrossSectionTable_h 1
+
+#include "globals.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+class CrossSectionTable {
+public:
+  // Grid of pointsPerDecade points per decade from minEnergy to (at
+  // least) maxEnergy, values set to zero
+  //
+  CrossSectionTable(G4double minEnergy, G4double maxEnergy,
+                    G4int pointsPerDecade);
+
+  std::size_t GetNPoints() const { return fValues.size(); }
+  G4double GetEnergy(std::size_t i) const;
+  G4double GetValue(std::size_t i) const { return fValues[i]; }
+  void SetValue(std::size_t i, G4double value) { fValues[i] = value; }
+
+  // Adds weight times the values of a table with the same grid
+  //
+  void Add(const CrossSectionTable &table, G4double weight);
+
+  inline G4double Evaluate(G4double energy) const;
+  void Evaluate(const G4double *energies, std::size_t n,
+                G4double *values) const;
+
+private:
+  G4double fLogMinEnergy;
+  G4double fInvLogStep; // points per unit of log energy
+  G4double fMaxIndex;   // last interval, as a real number
+  std::vector<G4double> fValues;
+};
+
+inline G4double CrossSectionTable::Evaluate(G4double energy) const {
+  const G4double u = std::min(
+      std::max((std::log(energy) - fLogMinEnergy) * fInvLogStep, 0.),
+      fMaxIndex);
+  const std::size_t i = std::min(static_cast<std::size_t>(u),
+                                 fValues.size() - 2);
+  return fValues[i] + (u - i) * (fValues[i + 1] - fValues[i]);
+}
+
+#endif // CrossSectionTable_h
+
+//**************************************************
@@ -0,0 +1,105 @@
+//**************************************************
+// \file EarlyStop.hh
+// \brief: Definition of Welford and EarlyStop classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Stopping rule of the event loop of a point: stop once the relative
+// statistical error on the mean of selected per-event observables (e.g.
+// E_loss, neutron energy) is below a target, or once a wall-clock budget
+// is spent, whichever comes first.
+// Each thread accumulates the observables of its events online (Welford
+// algorithm) and publishes a snapshot every updateEvents events; the
+// snapshots of all threads are merged and checked at each publication,
+// and the threads poll a shared flag at every event.
+// Each event only depends on its id, but the number of events processed
+// by each thread when the rule is met depends on the thread scheduling.
+
+#ifndef EarlyStop_h
+#define EarlyStop_h 1
+
+#include "globals.hh"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Online mean and variance (Welford), mergeable (Chan et al.)
+//
+class Welford {
+public:
+  inline void Add(G4double x);
+  void Merge(const Welford &other);
+
+  std::uint64_t GetN() const { return fN; }
+  G4double GetMean() const { return fMean; }
+  G4double GetVariance() const { return fN > 1 ? fM2 / (fN - 1) : 0.; }
+
+  // Relative error on the mean, infinite with less than two values or a
+  // null mean
+  //
+  G4double GetRelativeError() const;
+
+private:
+  std::uint64_t fN = 0;
+  G4double fMean = 0.;
+  G4double fM2 = 0.;
+};
+
+class EarlyStop {
+public:
+  static constexpr std::size_t updateEvents = 100;
+
+  EarlyStop(const std::vector<G4String> &observables, G4int nThreads);
+
+  // Target relative error on the mean of an observable, false if the
+  // observable is unknown
+  //
+  G4bool SetTarget(const G4String &observable, G4double relativeError);
+  void SetTimeBudget(G4double seconds) { fTimeBudget = seconds; }
+  G4bool IsActive() const;
+
+  // Reset the statistics and start the clock, before each point
+  //
+  void Start();
+
+  inline G4bool ShouldStop() const {
+    return fStop.load(std::memory_order_relaxed);
+  }
+
+  // Publish the statistics of a thread (one Welford per observable) and
+  // check the stopping rule
+  //
+  void Update(G4int thread, const std::vector<Welford> &stats);
+
+  // Merged means and relative errors, and why the point stopped
+  //
+  void Print() const;
+
+private:
+  std::vector<Welford> Merged() const;
+
+  std::vector<G4String> fObservables;
+  std::vector<G4double> fTargets; // 0 if no target
+  G4double fTimeBudget = 0.;      // seconds, 0 if no budget
+  std::vector<std::vector<Welford>> fSnapshots; // per thread
+  std::chrono::steady_clock::time_point fStart;
+  G4String fReason;
+  std::atomic<G4bool> fStop{false};
+  mutable std::mutex fMutex;
+};
+
+inline void Welford::Add(G4double x) {
+  fN++;
+  const G4double delta = x - fMean;
+  fMean += delta / fN;
+  fM2 += delta * (x - fMean);
+}
+
+#endif // EarlyStop_h
+
+//**************************************************
@@ -0,0 +1,65 @@
+//**************************************************
+// \file EnergySpectrum.hh
+// \brief: Definition of EnergySpectrum class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Kinetic energy spectrum of the projectiles, either a built-in shape or
+// a tabulated one:
+// - "flat:min:max", "logflat:min:max" (dN/dE ~ 1/E) and
+//   "power:min:max:gamma" (dN/dE ~ E^-gamma), energies in GeV;
+// - the name of a text file with two columns, energy (GeV, increasing)
+//   and spectrum density, linearly interpolated ('#' starts a comment).
+// The spectrum is split into bins: a bin is drawn with an alias table
+// (Walker/Vose) built once at startup, i.e. in constant time whatever the
+// number of bins, then the energy is drawn exactly within the bin from
+// the shape (power law) or the linear interpolation (tabulated).
+// Sample() only reads the tables and uses the thread-local engine, so one
+// spectrum is shared by all the threads.
+
+#ifndef EnergySpectrum_h
+#define EnergySpectrum_h 1
+
+#include "globals.hh"
+#include <vector>
+
+class EnergySpectrum {
+public:
+  // Build the bins and the alias table from a description (see above),
+  // returns false if the description is malformed
+  //
+  G4bool Build(const G4String &description);
+
+  // Kinetic energy (Geant4 units)
+  //
+  G4double Sample() const;
+
+  G4double GetMinEnergy() const { return fEdges.front(); }
+  G4double GetMaxEnergy() const { return fEdges.back(); }
+
+  // Short label for file names, e.g. "logflat1-100"
+  //
+  const G4String &GetLabel() const { return fLabel; }
+
+private:
+  G4bool BuildPowerLaw(G4double minEnergy, G4double maxEnergy, G4double gamma);
+  G4bool BuildTabulated(const G4String &fileName);
+  void BuildAliasTable(const std::vector<G4double> &weights);
+  G4double SampleInBin(std::size_t bin, G4double u) const;
+
+  static const std::size_t nPowerLawBins = 256;
+
+  std::vector<G4double> fEdges;   // bin edges
+  std::vector<G4double> fDensity; // tabulated density at the edges
+  G4bool fTabulated = false;
+  G4double fGamma = 0.; // power-law index
+  std::vector<G4double> fProbability; // alias table: probability to keep
+  std::vector<std::size_t> fAlias;    // the bin, else its alias
+  G4String fLabel;
+};
+
+#endif // EnergySpectrum_h
+
+//**************************************************
@@ -0,0 +1,142 @@
+//**************************************************
+// \file EventWriter.hh
+// \brief: Definition of EventWriter and EventBuffer classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Event record output: each interaction is written as an event made of the
+// projectile, the target nucleus (at rest) and the secondaries, with their
+// 4-momenta, in HepMC3 ASCII (Asciiv3) or in a compact binary format.
+// Each sampling thread formats its events into its own EventBuffer, a
+// byte buffer, and hands full buffers over to the EventWriter, whose I/O
+// thread writes them to disk. The queue of full buffers is bounded: a
+// thread waits only if the disk cannot keep up. Written buffers are
+// recycled. Events are written in the order the buffers are handed over,
+// i.e. not sorted by event number when running on several threads.
+//
+// HepMC3 ASCII: units GeV and mm, particles 1 and 2 are the projectile
+// and the target (status 4), entering vertex -1, the secondaries have
+// status 1. Nuclei have PDG codes 100ZZZAAA0.
+//
+// Binary layout (native endianness):
+// "G4HFSEV1", uint32 metadata size, metadata (text); then for each event:
+// uint32 record size (bytes after this field), uint64 event, uint32 number
+// of particles, for each particle: int32 PDG, int32 status, double px, py,
+// pz, e, m (GeV), the first two being the projectile and the target;
+// then uint32 0 and "END!".
+
+#ifndef EventWriter_h
+#define EventWriter_h 1
+
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class EventWriter {
+public:
+  enum class Format { HepMC3, Binary };
+
+  static const std::size_t bufferBytes = 1 << 20;
+  static const std::size_t maxQueuedBuffers = 16;
+
+  EventWriter() = default;
+  ~EventWriter();
+  EventWriter(const EventWriter &) = delete;
+  EventWriter &operator=(const EventWriter &) = delete;
+
+  // Open the file and start the I/O thread, metadata is free text
+  // describing the run
+  //
+  G4bool Open(const G4String &fileName, Format format,
+              const G4String &metadata);
+
+  // Write the pending buffers and the trailer, stop the I/O thread and
+  // close the file. All the event buffers must have been flushed before.
+  //
+  void Close();
+
+  Format GetFormat() const { return fFormat; }
+
+  // Buffer exchange with the event buffers (thread-safe), Submit waits
+  // while the queue is full
+  //
+  std::unique_ptr<std::string> GetBuffer();
+  void Submit(std::unique_ptr<std::string> buffer);
+
+private:
+  void WriteLoop();
+
+  Format fFormat = Format::HepMC3;
+  std::ofstream fFile;
+  std::thread fThread;
+  std::mutex fMutex;
+  std::condition_variable fCondition; // queue not empty, or closing
+  std::condition_variable fSpace;     // queue not full
+  std::deque<std::unique_ptr<std::string>> fQueue;
+  std::vector<std::unique_ptr<std::string>> fFreeBuffers;
+  G4bool fClosing = false;
+};
+
+// Per-thread buffer of an EventWriter
+//
+class EventBuffer {
+public:
+  explicit EventBuffer(EventWriter *writer)
+      : fWriter(writer), fFormat(writer->GetFormat()),
+        fBuffer(writer->GetBuffer()) {}
+  ~EventBuffer() { Flush(); }
+  EventBuffer(const EventBuffer &) = delete;
+  EventBuffer &operator=(const EventBuffer &) = delete;
+
+  // An event: BeginEvent, AddSecondary for each secondary, EndEvent
+  // (4-momenta and masses in MeV)
+  //
+  void BeginEvent(std::uint64_t event, std::int32_t projectilePDG,
+                  G4double px, G4double py, G4double pz, G4double e,
+                  G4double m, G4int targetZ, G4int targetA,
+                  G4double targetMass);
+  inline void AddSecondary(std::int32_t pdg, G4double px, G4double py,
+                           G4double pz, G4double e, G4double m);
+  void EndEvent();
+
+  // Hand the current buffer over to the writer
+  //
+  void Flush();
+
+private:
+  struct Particle {
+    std::int32_t pdg;
+    std::int32_t status;
+    G4double px, py, pz, e, m; // GeV
+  };
+
+  void FormatHepMC3();
+  void FormatBinary();
+
+  EventWriter *fWriter;
+  EventWriter::Format fFormat;
+  std::unique_ptr<std::string> fBuffer;
+  std::uint64_t fEvent = 0;
+  std::vector<Particle> fParticles; // projectile, target, secondaries
+};
+
+inline void EventBuffer::AddSecondary(std::int32_t pdg, G4double px,
+                                      G4double py, G4double pz, G4double e,
+                                      G4double m) {
+  fParticles.push_back({pdg, 1, px / CLHEP::GeV, py / CLHEP::GeV,
+                        pz / CLHEP::GeV, e / CLHEP::GeV, m / CLHEP::GeV});
+}
+
+#endif // EventWriter_h
+
+//**************************************************
@@ -0,0 +1,165 @@
+//**************************************************
+// \file FinalStateLibrary.hh
+// \brief: Definition of FinalStateLibraryWriter and FinalStateLibrary
+//         classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Library of pre-sampled final states, for fast replay.
+// Interactions are grouped in bins of (projectile PDG, target element Z,
+// projectile kinetic energy); the secondaries are stored in the frame of
+// the sampling, projectile along +z and target at rest, as PDG code and
+// 4-momentum in single precision.
+// FinalStateLibraryWriter collects the interactions in memory and writes
+// the file; FinalStateLibrary memory-maps it and hands out interactions
+// without copying them, picks one at random in the bin of nearest energy
+// (in log scale), and replays it for a projectile direction, with a
+// random azimuthal rotation about the projectile axis and optionally a
+// boost along the axis to the requested energy (an approximation: the
+// final state keeps the invariant mass of the bin, so neither its energy
+// nor its momentum matches the new initial state).
+//
+// File layout (native endianness, 8-byte aligned sections):
+// Header, metadata (text); for each bin: uint32 offsets of its
+// interactions in its secondaries (number of interactions + 1), and its
+// Secondary records; the index of Bin records, sorted by (projectile,
+// Z, energy).
+
+#ifndef FinalStateLibrary_h
+#define FinalStateLibrary_h 1
+
+#include "G4LorentzVector.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace CLHEP {
+class HepRandomEngine;
+}
+
+namespace fslib {
+struct Header {
+  char magic[8]; // "G4HFSFL1"
+  std::uint64_t metadataSize;
+  std::uint64_t nBins;
+  std::uint64_t indexOffset;
+};
+
+struct Secondary {
+  std::int32_t pdg;
+  float px, py, pz, e; // MeV
+};
+
+struct Bin {
+  std::int32_t projectilePDG;
+  std::int32_t targetZ;
+  G4double energy;         // projectile kinetic energy, MeV
+  G4double projectileMass; // MeV
+  G4double targetMass;     // MeV, of the first sampled isotope
+  std::uint64_t offsetsOffset;
+  std::uint64_t secondariesOffset;
+  std::uint32_t nInteractions;
+  std::uint32_t nSecondaries;
+};
+} // namespace fslib
+
+class FinalStateLibraryWriter {
+public:
+  // Start an interaction, in the bin of its projectile, energy and target
+  //
+  void BeginInteraction(std::int32_t projectilePDG, G4double energy,
+                        G4int targetZ, G4double projectileMass,
+                        G4double targetMass);
+  inline void AddSecondary(std::int32_t pdg, G4double px, G4double py,
+                           G4double pz, G4double e);
+
+  std::size_t GetNBins() const { return fBins.size(); }
+  G4bool Write(const G4String &fileName, const G4String &metadata) const;
+
+private:
+  struct BinData {
+    fslib::Bin bin;
+    std::vector<std::uint32_t> offsets{0};
+    std::vector<fslib::Secondary> secondaries;
+  };
+
+  std::map<std::tuple<std::int32_t, std::int32_t, G4double>, BinData> fBins;
+  BinData *fCurrent = nullptr;
+};
+
+class FinalStateLibrary {
+public:
+  // An interaction of the library, pointing into the mapped file
+  //
+  struct Interaction {
+    const fslib::Bin *bin;
+    const fslib::Secondary *secondaries;
+    std::size_t nSecondaries;
+  };
+
+  // A replayed secondary
+  //
+  struct Particle {
+    G4int pdg;
+    G4LorentzVector momentum;
+  };
+
+  FinalStateLibrary() = default;
+  ~FinalStateLibrary() { Close(); }
+  FinalStateLibrary(const FinalStateLibrary &) = delete;
+  FinalStateLibrary &operator=(const FinalStateLibrary &) = delete;
+
+  G4bool Open(const G4String &fileName);
+  void Close();
+
+  std::size_t GetNBins() const { return fNBins; }
+  const fslib::Bin *GetBins() const { return fBins; }
+  G4String GetMetadata() const;
+
+  // Bin of the projectile and target element with the nearest energy (in
+  // log scale), nullptr if none
+  //
+  const fslib::Bin *FindBin(G4int projectilePDG, G4int targetZ,
+                            G4double energy) const;
+
+  Interaction GetInteraction(const fslib::Bin &bin, std::size_t i) const;
+
+  // Random interaction of the nearest bin, bin is nullptr if none
+  //
+  Interaction Sample(G4int projectilePDG, G4int targetZ, G4double energy,
+                     CLHEP::HepRandomEngine &engine) const;
+
+  // Secondaries of an interaction for a projectile of given direction and
+  // kinetic energy: random rotation about the projectile axis, rotation of
+  // +z onto the direction, and if boost is true a boost along the axis
+  // from the energy of the bin to the given one. particles is cleared
+  // first but keeps its capacity.
+  //
+  void Replay(const Interaction &interaction, const G4ThreeVector &direction,
+              G4double energy, G4bool boost, CLHEP::HepRandomEngine &engine,
+              std::vector<Particle> &particles) const;
+
+private:
+  const char *fData = nullptr;
+  std::size_t fSize = 0;
+  const fslib::Bin *fBins = nullptr;
+  std::size_t fNBins = 0;
+};
+
+inline void FinalStateLibraryWriter::AddSecondary(std::int32_t pdg,
+                                                  G4double px, G4double py,
+                                                  G4double pz, G4double e) {
+  fCurrent->secondaries.push_back(
+      {pdg, static_cast<float>(px), static_cast<float>(py),
+       static_cast<float>(pz), static_cast<float>(e)});
+  fCurrent->offsets.back()++;
+}
+
+#endif // FinalStateLibrary_h
+
+//**************************************************
@@ -71,14 +71,31 @@
 #include "globals.hh"
 #include "G4ios.hh"
 #include "G4ThreeVector.hh"
+#include "G4Version.hh"
+#include <array>
+#include <chrono>
+#include <functional>
 #include <map>
+#include <utility>
+#include <vector>
 #include "G4HadronicProcess.hh"
+#include "CrossSectionTable.hh"
+#include "ParticleIndexMap.hh"
 
 class G4ParticleDefinition;
 class G4VParticleChange;
 class G4ParticleTable;
 class G4Material;
 class G4HadronicInteraction;
+class G4VCrossSectionDataSet;
+class G4PreCompoundModel;
+class G4GeneratorPrecompoundInterface;
+class G4FTFModel;
+class G4DynamicParticle;
+class G4Track;
+class G4Step;
+class SecondariesBuffer;
+class InteractionProfiler;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -93,6 +110,15 @@ class HadronicGenerator {
   // with a separate instance of this class in each thread.
   public:
 
+    enum class PhysicsCase { FTFP_BERT_ATL, FTFP_BERT, QGSP_BERT, QGSP_BIC, FTFP_INCLXX,
+                             BERT, BIC, IonBIC, INCL, FTFP, QGSP, Unsupported };
+    // Physics cases as enumerators: the name given to the constructor is resolved
+    // only once, and then only the enumerator is used.
+
+    static PhysicsCase ToPhysicsCase( const G4String &physicsCase );
+    // Returns the enumerator corresponding to the name of the physics case,
+    // "Unsupported" if the name is not known.
+
     explicit HadronicGenerator( const G4String physicsCase = "FTFP_BERT_ATL" );
     // Currently supported final-state hadronic inelastic "physics cases":
     // -  Hadronic models :        BERT, BIC, IonBIC, INCL, FTFP, QGSP
@@ -110,6 +136,38 @@ class HadronicGenerator {
     //     physics lists).
 
     ~HadronicGenerator();
+    // Deletes only what the generator owns (the step, the track and the secondaries
+    // of the last interaction): the particles and the hadronic processes, models and
+    // cross sections stay in the Geant4 tables, so that several generators (e.g. one
+    // per thread) can be deleted in any order.
+
+    G4bool PrepareProjectile( G4ParticleDefinition* projectileDefinition );
+    // Sets up the hadronic inelastic process of the projectile - with only the
+    // hadronic models and cross sections it needs - if not already done.
+    // The constructor creates only the particles: a process is otherwise set up at
+    // the first call of "GenerateInteraction" for its projectile. Calling this
+    // method beforehand keeps the initialization out of the event loop (and, in a
+    // multi-threaded application, allows to serialize it).
+    // Returns "false" if the projectile has no hadronic inelastic process.
+
+    inline void SetCrossSectionCacheDir( const G4String &cacheDir );
+    // Directory of the on-disk cache of the tabulated cross sections (empty, the
+    // default, means no cache). It applies to the projectiles set up afterwards,
+    // i.e. it should be set before calling "PrepareProjectile".
+
+    inline void SetCrossSectionCacheEnergies( const std::vector< G4double > &energies );
+    // Kinetic energies at which the cache holds the cross sections: those the run
+    // will ask for. Any other energy is computed by the cross-section dataset, so
+    // that the events are the same with or without the cache.
+
+    inline void SetProfiler( InteractionProfiler* profiler );
+    // Profiler (not owned) filled by "GenerateInteraction" with the wall time,
+    // the number of calls and the secondaries of each (process, selected model)
+    // pair; nullptr, the default, means no profiling.
+
+    void PrintInitTimes() const;
+    // Prints the wall-clock time spent to set up each component
+    // (particles, hadronic models, cross sections and processes).
 
     inline G4bool IsPhysicsCaseSupported() const;
     // Returns "true" if the physicsCase is supported; "false" otherwise. 
@@ -119,6 +177,8 @@ class HadronicGenerator {
                          const G4double projectileEnergy ) const;
     // Returns "true" if the specified projectile (either by name or particle definition)
     // of given energy is applicable, "false" otherwise.
+    // The check is a lookup in the applicability table built by the constructor:
+    // one hash probe to get the dense index of the particle and two comparisons.
 
     G4VParticleChange* GenerateInteraction( const G4String &nameProjectile,
                                             const G4double projectileEnergy,
@@ -133,13 +193,63 @@ class HadronicGenerator {
     // its energy, its direction and the target material, and it returns one sampled
     // final-state of the inelastic hadron-nuclear collision as modelled by the
     // final-state hadronic inelastic "physics case" specified in the constructor.
-    // If the required hadronic collision is not possible, then the method returns
-    // immediately an empty "G4VParticleChange", i.e. without secondaries produced.
+    // If the required hadronic collision is not possible (projectile not applicable
+    // at that energy, or no hadronic process for it), then the method returns
+    // immediately nullptr, which the caller must check before using the result.
+    // The returned final state - the particle change and its secondary tracks - is
+    // owned by the generator: it is valid until the next call of this method (or of
+    // "ReleaseInteraction"), which deletes the secondaries and clears the change.
+    // The caller must neither delete the secondaries nor keep pointers to them.
+
+    void ReleaseInteraction();
+    // Deletes the secondary tracks (and their dynamic particles) of the last call of
+    // "GenerateInteraction" and clears its particle change. Tracks and dynamic
+    // particles come from the Geant4 per-thread pooled allocators, so the memory is
+    // recycled by the next interactions and stays constant along the run.
+    // Calling it is optional: "GenerateInteraction" and the destructor call it.
+
+    G4int GenerateInteractions( G4ParticleDefinition* projectileDefinition,
+                                const G4double projectileEnergy,
+                                const G4ThreeVector &projectileDirection,
+                                G4Material* targetMaterial,
+                                const G4int nInteractions,
+                                SecondariesBuffer &secondaries,
+                                const std::function< void( G4int ) > &beginInteraction = {} );
+    // Batch version of "GenerateInteraction": it samples nInteractions final-states
+    // for the same projectile, energy, direction and target material, and copies
+    // their secondaries (PDG code, momentum, total and kinetic energy) and the Z and
+    // A of their target nucleus into the structure-of-arrays buffer, which is
+    // cleared first but keeps its capacity. "beginInteraction", if set, is called
+    // with the index of each interaction in the batch before sampling it (e.g. to
+    // seed the random engine per interaction). The secondary tracks are released
+    // once copied. Returns the number of sampled interactions (0 if the required
+    // hadronic collision is not possible).
+
+    G4bool GetElementCrossSections( G4ParticleDefinition* projectileDefinition, const G4int Z,
+                                    const G4double* energies, const std::size_t n,
+                                    G4double* crossSections );
+    G4bool GetMaterialCrossSections( G4ParticleDefinition* projectileDefinition,
+                                     const G4Material* targetMaterial,
+                                     const G4double* energies, const std::size_t n,
+                                     G4double* crossSections );
+    // Inelastic cross sections of the projectile, as used by "GenerateInteraction", at
+    // the n kinetic energies: per atom of the element Z (in Geant4 units of area), and
+    // per volume of the material (macroscopic cross section, the inverse of the
+    // interaction length). The cross sections are tabulated on first use for each
+    // (projectile, element) and (projectile, material) on a logarithmic energy grid
+    // (1 keV - 1000 TeV, 50 points per decade), and then interpolated in batch (see
+    // CrossSectionTable), so that no Geant4 dataset is called in the queries.
+    // Returns "false", without filling crossSections, if the projectile has no hadronic
+    // inelastic process.
 
     inline G4HadronicProcess* GetHadronicProcess() const;
-    //inline G4HadronicInteraction* GetHadronicInteraction() const;
+    #if G4VERSION_NUMBER >= 1100
+    inline G4HadronicInteraction* GetHadronicInteraction() const;
+    #endif
     // Returns the hadronic process and the hadronic interaction, respectively,
     // that handled the last call of "GenerateInteraction".
+    // (The hadronic interaction is available only for Geant4 >= 11.0, because
+    //  G4HadronicProcess::GetHadronicInteraction is protected in earlier versions.)
 
     G4double GetImpactParameter() const;
     G4int GetNumberOfTargetSpectatorNucleons() const;
@@ -152,11 +262,91 @@ class HadronicGenerator {
 
   private:
 
+    struct EnergyRange {
+      G4double fMin;
+      G4double fMax;
+    };
+    // Kinetic energy interval, limits included, of the applicability of a projectile.
+
+    enum class Model { BERT, BIC, IonBIC, INCL, FTFP, FTFP_aboveThreshold, FTFP_constrained,
+                       FTFP_belowThreshold, QGSP, NumberOfModels };
+    enum class CrossSection { PionMinus, PionPlus, Kaon, Proton, Neutron, Hyperon, Antibaryon,
+                              NuclNucl, NumberOfCrossSections };
+    enum class ProjectileGroup { Pion, Kaon, Nucleon, Ion, Hyperon, AntiBaryon, AntiIon,
+                                 HeavyFlavour };
+    // Hadronic models, cross sections and groups of projectiles sharing the same models.
+
+    struct Projectile {
+      G4ParticleDefinition* fDefinition;
+      G4String fProcessName;
+      CrossSection fCrossSection;
+      ProjectileGroup fGroup;
+    };
+    // Entry of the table of the projectiles with an hadronic inelastic process.
+
+    void BuildApplicabilityTable();
+    inline G4bool IsApplicableIndex( const G4int projectileIndex,
+                                     const G4double projectileEnergy ) const;
+    G4HadronicProcess* GetProcess( const G4int projectileIndex );
+    void RegisterModels( G4HadronicProcess* theProcess, const ProjectileGroup group );
+    G4HadronicInteraction* GetModel( const Model model );
+    void SetModelEnergyRange( const Model model, G4HadronicInteraction* theModel ) const;
+    G4VCrossSectionDataSet* GetCrossSection( const CrossSection crossSection,
+                                             G4ParticleDefinition* projectile );
+    G4HadronicProcess* GetProjectileProcess( G4ParticleDefinition* projectileDefinition );
+    const CrossSectionTable* GetElementTable( G4ParticleDefinition* projectileDefinition,
+                                              const G4int Z );
+    const CrossSectionTable* GetMaterialTable( G4ParticleDefinition* projectileDefinition,
+                                               const G4Material* targetMaterial );
+    // Process of the projectile (the one of GenericIon for ions), set up if needed, and
+    // tabulated cross sections, built on first use (nullptr if no process).
+    G4PreCompoundModel* GetPreCompoundModel();
+    G4GeneratorPrecompoundInterface* GetPrecompoundInterface();
+    G4FTFModel* GetFTFStringModel();
+    void AddInitTime( const G4String &component,
+                      const std::chrono::steady_clock::time_point &startTime );
+    // Builders of the processes, models and cross sections: each object is created
+    // on first use and then kept.
+
     G4String fPhysicsCase;
+    PhysicsCase fPhysicsCaseId;
     G4bool fPhysicsCaseIsSupported;
     G4HadronicProcess* fLastHadronicProcess;
+    G4VParticleChange* fLastChange;  // final state to release, nullptr if none
+    G4ParticleDefinition* fLastProjectile;
+    G4int fLastProjectileIndex;
+    G4int fLastProcessIndex;
+    // Projectile of the last call of "GenerateInteraction", with its dense index
+    // and the one of its process (they differ for ions, handled by GenericIon).
     G4ParticleTable* fPartTable;
-    std::map< G4ParticleDefinition*, G4HadronicProcess* > fProcessMap;  
+    std::vector< Projectile > fProjectiles;  // indexed by the dense particle index
+    std::vector< G4HadronicProcess* > fProcesses;  // same index, nullptr if not yet set up
+    ParticleIndexMap fParticleIndex;  // dense index of the particles with a process
+    std::vector< EnergyRange > fApplicability;  // indexed by the dense particle index
+    EnergyRange fDefaultApplicability;  // for the particles without a dense index
+    G4DynamicParticle* fDynamicParticle;  // owned by fTrack
+    G4Track* fTrack;
+    G4Step* fStep;
+    // Projectile track & step, created once in the constructor and reset
+    // in place at each call of "GenerateInteraction".
+    std::array< G4HadronicInteraction*,
+                static_cast< std::size_t >( Model::NumberOfModels ) > fModels;
+    std::array< G4VCrossSectionDataSet*,
+                static_cast< std::size_t >( CrossSection::NumberOfCrossSections ) > fCrossSections;
+    G4PreCompoundModel* fPreEquilib;
+    G4GeneratorPrecompoundInterface* fPrecoInterface;
+    G4FTFModel* fFTFStringModel;
+    // Hadronic models and cross sections built so far (nullptr if not yet needed),
+    // and the components shared between models.
+    std::vector< std::pair< G4String, G4double > > fInitTimes;  // component, seconds
+    G4String fCrossSectionCacheDir;
+    std::vector< G4double > fCrossSectionCacheEnergies;
+    InteractionProfiler* fProfiler;
+    std::map< std::pair< const G4ParticleDefinition*, G4int >,
+              CrossSectionTable > fElementTables;
+    std::map< std::pair< const G4ParticleDefinition*, const G4Material* >,
+              CrossSectionTable > fMaterialTables;
+    // Tabulated cross sections per (projectile, element Z) and (projectile, material).
 };
 
 
@@ -165,15 +355,40 @@ inline G4bool HadronicGenerator::IsPhysicsCaseSupported() const {
 }
 
 
+inline void HadronicGenerator::SetCrossSectionCacheDir( const G4String &cacheDir ) {
+  fCrossSectionCacheDir = cacheDir;
+}
+
+
+inline void HadronicGenerator::SetCrossSectionCacheEnergies( const std::vector< G4double > &energies ) {
+  fCrossSectionCacheEnergies = energies;
+}
+
+
+inline void HadronicGenerator::SetProfiler( InteractionProfiler* profiler ) {
+  fProfiler = profiler;
+}
+
+
 inline G4HadronicProcess* HadronicGenerator::GetHadronicProcess() const {
   return fLastHadronicProcess;
 }
 
 
-/*inline G4HadronicInteraction* HadronicGenerator::GetHadronicInteraction() const {
+inline G4bool HadronicGenerator::IsApplicableIndex( const G4int projectileIndex,
+                                                   const G4double projectileEnergy ) const {
+  const EnergyRange &range =
+    projectileIndex >= 0 ? fApplicability[ projectileIndex ] : fDefaultApplicability;
+  return projectileEnergy >= range.fMin  &&  projectileEnergy <= range.fMax;
+}
+
+
+#if G4VERSION_NUMBER >= 1100
+inline G4HadronicInteraction* HadronicGenerator::GetHadronicInteraction() const {
   return fLastHadronicProcess == nullptr ? nullptr
                                          : fLastHadronicProcess->GetHadronicInteraction();
-}*/
+}
+#endif
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
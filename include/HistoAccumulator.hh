@@ -0,0 +1,137 @@
+//**************************************************
+// \file HistoAccumulator.hh
+// \brief: Definition of H1Accumulator and H2Accumulator classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Lightweight fixed-bin histograms, backed by one contiguous array of bins
+// (underflow and overflow included), each bin holding the same sums as the
+// g4tools histograms (entries, sum of w, w^2, x*w, x^2*w, ...). A fill is
+// one multiplication and one bin update, without any virtual call or lock.
+// Each thread fills its own copies, which are added together at the end of
+// the run and written into the histograms booked with G4AnalysisManager,
+// with the same binning, only once.
+
+#ifndef HistoAccumulator_h
+#define HistoAccumulator_h 1
+
+#include "globals.hh"
+#include "tools/histo/h1d"
+#include "tools/histo/h2d"
+#include <cstdint>
+#include <vector>
+
+// Binning of one axis
+//
+class HistoAxis {
+public:
+  HistoAxis(G4int nBins, G4double min, G4double max);
+
+  G4int GetNBins() const { return fNBins; }
+
+  // Bin index: 0 for underflow (and NaN), nBins + 1 for overflow
+  //
+  inline std::size_t Index(G4double x) const;
+
+private:
+  G4int fNBins;
+  G4double fMin;
+  G4double fMax;
+  G4double fBinsPerUnit;
+};
+
+class H1Accumulator {
+public:
+  H1Accumulator(G4int nBins, G4double min, G4double max)
+      : fAxis(nBins, min, max), fBins(nBins + 2) {}
+
+  inline void Fill(G4double x, G4double weight = 1.);
+
+  // Add another accumulator with the same binning
+  //
+  void Add(const H1Accumulator &other);
+
+  // Write all the bins (empty ones included) into a histogram with the same
+  // binning, replacing its content, returns false if the number of bins
+  // differs or a bin cannot be set
+  //
+  G4bool WriteTo(tools::histo::h1d &histo) const;
+
+private:
+  struct Bin {
+    std::uint64_t entries = 0;
+    G4double sw = 0.;
+    G4double sw2 = 0.;
+    G4double sxw = 0.;
+    G4double sx2w = 0.;
+  };
+
+  HistoAxis fAxis;
+  std::vector<Bin> fBins;
+};
+
+class H2Accumulator {
+public:
+  H2Accumulator(G4int nBinsX, G4double minX, G4double maxX, G4int nBinsY,
+                G4double minY, G4double maxY)
+      : fAxisX(nBinsX, minX, maxX), fAxisY(nBinsY, minY, maxY),
+        fBins((nBinsX + 2) * (nBinsY + 2)) {}
+
+  inline void Fill(G4double x, G4double y, G4double weight = 1.);
+
+  void Add(const H2Accumulator &other);
+  G4bool WriteTo(tools::histo::h2d &histo) const;
+
+private:
+  struct Bin {
+    std::uint64_t entries = 0;
+    G4double sw = 0.;
+    G4double sw2 = 0.;
+    G4double sxw = 0.;
+    G4double sx2w = 0.;
+    G4double syw = 0.;
+    G4double sy2w = 0.;
+  };
+
+  HistoAxis fAxisX;
+  HistoAxis fAxisY;
+  std::vector<Bin> fBins; // x index + (nBinsX + 2) * y index
+};
+
+inline std::size_t HistoAxis::Index(G4double x) const {
+  if (!(x >= fMin)) {
+    return 0;
+  }
+  if (x >= fMax) {
+    return fNBins + 1;
+  }
+  const std::size_t bin =
+      static_cast<std::size_t>((x - fMin) * fBinsPerUnit);
+  return bin < static_cast<std::size_t>(fNBins) ? bin + 1 : fNBins;
+}
+
+inline void H1Accumulator::Fill(G4double x, G4double weight) {
+  Bin &bin = fBins[fAxis.Index(x)];
+  bin.entries++;
+  bin.sw += weight;
+  bin.sw2 += weight * weight;
+  bin.sxw += x * weight;
+  bin.sx2w += x * x * weight;
+}
+
+inline void H2Accumulator::Fill(G4double x, G4double y, G4double weight) {
+  Bin &bin = fBins[fAxisX.Index(x) + (fAxisX.GetNBins() + 2) * fAxisY.Index(y)];
+  bin.entries++;
+  bin.sw += weight;
+  bin.sw2 += weight * weight;
+  bin.sxw += x * weight;
+  bin.sx2w += x * x * weight;
+  bin.syw += y * weight;
+  bin.sy2w += y * y * weight;
+}
+
+#endif // HistoAccumulator_h
+
+//**************************************************
@@ -0,0 +1,86 @@
+//**************************************************
+// \file InteractionProfiler.hh
+// \brief: Definition of InteractionProfiler class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Wall time, number of calls and secondary multiplicity of the hadronic
+// interactions sampled by a HadronicGenerator, per (process, model) pair,
+// where the model is the one selected by the process for the interaction
+// (e.g. BERT or FTFP in the transition region of FTFP_BERT).
+// A profiler is filled by a single HadronicGenerator, i.e. by a single
+// thread, without locking; the profilers of several threads are merged
+// at the end. The model is known only for Geant4 11.0 and up (it is
+// reported as "unknown" otherwise).
+
+#ifndef InteractionProfiler_h
+#define InteractionProfiler_h 1
+
+#include "globals.hh"
+#include <cstdint>
+#include <vector>
+
+class G4HadronicInteraction;
+class G4HadronicProcess;
+
+class InteractionProfiler {
+public:
+  struct Entry {
+    const G4HadronicProcess *process;
+    const G4HadronicInteraction *model;
+    G4String processName;
+    G4String modelName;
+    std::uint64_t calls;
+    std::uint64_t nanoseconds;
+    std::uint64_t secondaries;
+  };
+
+  // Add one interaction, of duration ns and with nSecondaries secondaries
+  //
+  inline void Record(const G4HadronicProcess *process,
+                     const G4HadronicInteraction *model, std::uint64_t ns,
+                     G4int nSecondaries);
+
+  // Add the entries of another profiler, matched by process and model name
+  //
+  void Merge(const InteractionProfiler &other);
+
+  void Clear() { fEntries.clear(); }
+  const std::vector<Entry> &GetEntries() const { return fEntries; }
+
+  // Summary table, sorted by total time
+  //
+  void Print() const;
+  G4bool WriteJSON(const G4String &fileName) const;
+
+private:
+  Entry &AddEntry(const G4HadronicProcess *process,
+                  const G4HadronicInteraction *model);
+
+  std::vector<Entry> fEntries; // a handful: linear search
+};
+
+inline void InteractionProfiler::Record(const G4HadronicProcess *process,
+                                        const G4HadronicInteraction *model,
+                                        std::uint64_t ns,
+                                        G4int nSecondaries) {
+  Entry *entry = nullptr;
+  for (Entry &candidate : fEntries) {
+    if (candidate.process == process && candidate.model == model) {
+      entry = &candidate;
+      break;
+    }
+  }
+  if (entry == nullptr) {
+    entry = &AddEntry(process, model);
+  }
+  entry->calls++;
+  entry->nanoseconds += ns;
+  entry->secondaries += nSecondaries;
+}
+
+#endif // InteractionProfiler_h
+
+//**************************************************
@@ -0,0 +1,176 @@
+//**************************************************
+// \file NtupleWriter.hh
+// \brief: Definition of NtupleWriter and NtupleBuffer classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Columnar binary output of the secondaries, one row per secondary.
+// Each sampling thread fills its own NtupleBuffer, a chunk of columns,
+// and hands full chunks over to the NtupleWriter, whose I/O thread
+// writes them to disk while the sampling continues. Written chunks are
+// recycled, so that the steady state does not allocate, and at most
+// maxQueuedChunks full chunks wait for the I/O thread: a thread submitting
+// a chunk to a full queue blocks until the disk catches up, which bounds
+// the memory.
+// Rows are in event order within a chunk, but the chunks of the threads
+// are written in the order they are submitted: the rows of different
+// threads are interleaved and not in event order (sort by the event column
+// to get it).
+//
+// File layout (native endianness, see util/readntuple.py):
+// "G4HFSNT1", uint32 metadata size, metadata (text),
+// uint32 number of columns, for each column: uint8 type size,
+// uint8 type kind ('u', 'i' or 'f'), uint8 name size, name;
+// then chunks: "CHNK", uint64 rows, the columns one after the other;
+// then "MODL", uint32 models, for each model: uint16 size, name;
+// then "END!". Energies and momenta are in MeV, projectile_ekin is the
+// kinetic energy of the projectile of the event.
+
+#ifndef NtupleWriter_h
+#define NtupleWriter_h 1
+
+#include "globals.hh"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class NtupleWriter {
+public:
+  // Columns of a chunk
+  //
+  struct Chunk {
+    std::vector<std::uint64_t> event;
+    std::vector<std::int32_t> pdg;
+    std::vector<G4double> px;
+    std::vector<G4double> py;
+    std::vector<G4double> pz;
+    std::vector<G4double> e;
+    std::vector<G4double> ekin;
+    std::vector<std::int16_t> model; // index in the model table
+    std::vector<std::int16_t> targetZ;
+    std::vector<std::int16_t> targetA;
+    std::vector<G4double> projectileEkin;
+
+    std::size_t GetRows() const { return event.size(); }
+    void Reserve(std::size_t rows);
+    void Clear();
+  };
+
+  static const std::size_t chunkRows = 1 << 16;
+  static const std::size_t maxQueuedChunks = 16;
+
+  NtupleWriter() = default;
+  ~NtupleWriter();
+  NtupleWriter(const NtupleWriter &) = delete;
+  NtupleWriter &operator=(const NtupleWriter &) = delete;
+
+  // Open the file and start the I/O thread, metadata is free text
+  // describing the run (physics list, projectile, ...)
+  //
+  G4bool Open(const G4String &fileName, const G4String &metadata);
+
+  // Write the pending chunks and the model table, stop the I/O thread and
+  // close the file. All the buffers must have been flushed before.
+  //
+  void Close();
+
+  // Index of a model name in the model table (thread-safe)
+  //
+  std::int16_t RegisterModel(const G4String &modelName);
+
+  // Chunk exchange with the buffers (thread-safe), Submit blocks while
+  // maxQueuedChunks chunks are waiting to be written
+  //
+  std::unique_ptr<Chunk> GetChunk();
+  void Submit(std::unique_ptr<Chunk> chunk);
+
+private:
+  void WriteLoop();
+  void WriteChunk(const Chunk &chunk);
+
+  std::ofstream fFile;
+  std::thread fThread;
+  std::mutex fMutex;
+  std::condition_variable fCondition; // queue not empty, or closing
+  std::condition_variable fSpace;     // queue not full
+  std::deque<std::unique_ptr<Chunk>> fQueue;
+  std::vector<std::unique_ptr<Chunk>> fFreeChunks;
+  std::vector<G4String> fModels;
+  G4bool fClosing = false;
+};
+
+// Per-thread buffer of an NtupleWriter
+//
+class NtupleBuffer {
+public:
+  explicit NtupleBuffer(NtupleWriter *writer)
+      : fWriter(writer), fChunk(writer->GetChunk()) {}
+  ~NtupleBuffer() { Flush(); }
+  NtupleBuffer(const NtupleBuffer &) = delete;
+  NtupleBuffer &operator=(const NtupleBuffer &) = delete;
+
+  // Index of the model in the model table, cached per thread
+  //
+  inline std::int16_t GetModelIndex(const void *model,
+                                    const G4String &modelName);
+
+  inline void Fill(std::uint64_t event, std::int32_t pdg, G4double px,
+                   G4double py, G4double pz, G4double e, G4double ekin,
+                   std::int16_t model, std::int16_t targetZ,
+                   std::int16_t targetA, G4double projectileEkin);
+
+  // Hand the current chunk over to the writer
+  //
+  void Flush();
+
+private:
+  NtupleWriter *fWriter;
+  std::unique_ptr<NtupleWriter::Chunk> fChunk;
+  std::vector<std::pair<const void *, std::int16_t>> fModels;
+};
+
+inline std::int16_t NtupleBuffer::GetModelIndex(const void *model,
+                                                const G4String &modelName) {
+  for (const auto &entry : fModels) {
+    if (entry.first == model) {
+      return entry.second;
+    }
+  }
+  fModels.emplace_back(model, fWriter->RegisterModel(modelName));
+  return fModels.back().second;
+}
+
+inline void NtupleBuffer::Fill(std::uint64_t event, std::int32_t pdg,
+                               G4double px, G4double py, G4double pz,
+                               G4double e, G4double ekin, std::int16_t model,
+                               std::int16_t targetZ, std::int16_t targetA,
+                               G4double projectileEkin) {
+  NtupleWriter::Chunk &chunk = *fChunk;
+  chunk.event.push_back(event);
+  chunk.pdg.push_back(pdg);
+  chunk.px.push_back(px);
+  chunk.py.push_back(py);
+  chunk.pz.push_back(pz);
+  chunk.e.push_back(e);
+  chunk.ekin.push_back(ekin);
+  chunk.model.push_back(model);
+  chunk.targetZ.push_back(targetZ);
+  chunk.targetA.push_back(targetA);
+  chunk.projectileEkin.push_back(projectileEkin);
+  if (chunk.GetRows() == NtupleWriter::chunkRows) {
+    fWriter->Submit(std::move(fChunk));
+    fChunk = fWriter->GetChunk();
+  }
+}
+
+#endif // NtupleWriter_h
+
+//**************************************************
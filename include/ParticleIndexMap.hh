@@ -0,0 +1,109 @@
+//**************************************************
+// \file ParticleIndexMap.hh
+// \brief: Definition of ParticleIndexMap class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Assigns a dense index (0, 1, 2, ...) to particle definitions and finds
+// it back from the G4ParticleDefinition pointer with an open-addressing
+// hash table. The table is kept at most 1/4 full, so that a lookup
+// almost always costs one probe in one cache line.
+// Meant to be filled once (e.g. in a constructor) and then only read,
+// it is therefore safe to share for reading across threads.
+
+#ifndef ParticleIndexMap_h
+#define ParticleIndexMap_h 1
+
+#include "globals.hh"
+#include <cstdint>
+#include <vector>
+
+class G4ParticleDefinition;
+
+class ParticleIndexMap {
+public:
+  ParticleIndexMap() : fSize(0), fShift(64 - 4), fSlots(16) {}
+
+  // Returns the index of the particle, assigning the next free one if the
+  // particle is new
+  //
+  inline G4int Insert(const G4ParticleDefinition *particle);
+
+  // Returns the index of the particle, -1 if the particle is not present
+  //
+  inline G4int Find(const G4ParticleDefinition *particle) const;
+
+  G4int GetSize() const { return fSize; }
+
+private:
+  struct Slot {
+    const G4ParticleDefinition *key = nullptr;
+    G4int index = -1;
+  };
+
+  // Fibonacci hashing of the pointer, the top bits are the slot
+  //
+  std::size_t Hash(const G4ParticleDefinition *particle) const {
+    return static_cast<std::size_t>(
+        (reinterpret_cast<std::uintptr_t>(particle) * 0x9E3779B97F4A7C15ull) >>
+        fShift);
+  }
+  inline void Grow();
+
+  G4int fSize;
+  G4int fShift;
+  std::vector<Slot> fSlots;
+};
+
+inline G4int ParticleIndexMap::Insert(const G4ParticleDefinition *particle) {
+  const G4int index = Find(particle);
+  if (index >= 0 || particle == nullptr) {
+    return index;
+  }
+  if (4 * (fSize + 1) > static_cast<G4int>(fSlots.size())) {
+    Grow();
+  }
+  const std::size_t mask = fSlots.size() - 1;
+  std::size_t slot = Hash(particle);
+  while (fSlots[slot].key != nullptr) {
+    slot = (slot + 1) & mask;
+  }
+  fSlots[slot].key = particle;
+  fSlots[slot].index = fSize;
+  return fSize++;
+}
+
+inline G4int
+ParticleIndexMap::Find(const G4ParticleDefinition *particle) const {
+  const std::size_t mask = fSlots.size() - 1;
+  for (std::size_t slot = Hash(particle); fSlots[slot].key != nullptr;
+       slot = (slot + 1) & mask) {
+    if (fSlots[slot].key == particle) {
+      return fSlots[slot].index;
+    }
+  }
+  return -1;
+}
+
+inline void ParticleIndexMap::Grow() {
+  std::vector<Slot> oldSlots(fSlots.size() * 2);
+  oldSlots.swap(fSlots);
+  fShift--;
+  const std::size_t mask = fSlots.size() - 1;
+  for (const Slot &old : oldSlots) {
+    if (old.key == nullptr) {
+      continue;
+    }
+    std::size_t slot = Hash(old.key);
+    while (fSlots[slot].key != nullptr) {
+      slot = (slot + 1) & mask;
+    }
+    fSlots[slot] = old;
+  }
+}
+
+#endif // ParticleIndexMap_h
+
+//**************************************************
@@ -0,0 +1,105 @@
+//**************************************************
+// \file SecondariesBuffer.hh
+// \brief: Definition of SecondariesBuffer class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Structure-of-arrays buffer holding the secondaries of a batch of
+// interactions, filled by HadronicGenerator::GenerateInteractions().
+// The secondaries of interaction i are stored in the index range
+// [GetOffsets()[i], GetOffsets()[i+1]) of every column, and its target
+// nucleus at index i of GetTargetZ() and GetTargetA().
+// Momenta and energies are in Geant4 internal units (MeV).
+// Clear() keeps the allocated capacity, so that a buffer reserved once
+// can be reused for all the batches without further allocations.
+
+#ifndef SecondariesBuffer_h
+#define SecondariesBuffer_h 1
+
+#include "globals.hh"
+#include <vector>
+
+class SecondariesBuffer {
+public:
+  SecondariesBuffer() { fOffsets.push_back(0); }
+
+  inline void Reserve(std::size_t nInteractions, std::size_t nSecondaries);
+  inline void Clear();
+
+  inline void AddSecondary(G4int pdg, G4double px, G4double py, G4double pz,
+                           G4double e, G4double ekin);
+  inline void CloseInteraction(G4int targetZ, G4int targetA);
+
+  std::size_t GetNumberOfInteractions() const { return fOffsets.size() - 1; }
+  std::size_t GetNumberOfSecondaries() const { return fPDG.size(); }
+
+  const std::size_t *GetOffsets() const { return fOffsets.data(); }
+  const G4int *GetPDG() const { return fPDG.data(); }
+  const G4double *GetPx() const { return fPx.data(); }
+  const G4double *GetPy() const { return fPy.data(); }
+  const G4double *GetPz() const { return fPz.data(); }
+  const G4double *GetE() const { return fE.data(); }
+  const G4double *GetEkin() const { return fEkin.data(); }
+  const G4int *GetTargetZ() const { return fTargetZ.data(); }
+  const G4int *GetTargetA() const { return fTargetA.data(); }
+
+private:
+  std::vector<std::size_t> fOffsets;
+  std::vector<G4int> fPDG;
+  std::vector<G4double> fPx;
+  std::vector<G4double> fPy;
+  std::vector<G4double> fPz;
+  std::vector<G4double> fE;
+  std::vector<G4double> fEkin;
+  std::vector<G4int> fTargetZ; // per interaction
+  std::vector<G4int> fTargetA; // per interaction
+};
+
+inline void SecondariesBuffer::Reserve(std::size_t nInteractions,
+                                       std::size_t nSecondaries) {
+  fOffsets.reserve(nInteractions + 1);
+  fTargetZ.reserve(nInteractions);
+  fTargetA.reserve(nInteractions);
+  fPDG.reserve(nSecondaries);
+  fPx.reserve(nSecondaries);
+  fPy.reserve(nSecondaries);
+  fPz.reserve(nSecondaries);
+  fE.reserve(nSecondaries);
+  fEkin.reserve(nSecondaries);
+}
+
+inline void SecondariesBuffer::Clear() {
+  fOffsets.resize(1);
+  fTargetZ.clear();
+  fTargetA.clear();
+  fPDG.clear();
+  fPx.clear();
+  fPy.clear();
+  fPz.clear();
+  fE.clear();
+  fEkin.clear();
+}
+
+inline void SecondariesBuffer::AddSecondary(G4int pdg, G4double px,
+                                            G4double py, G4double pz,
+                                            G4double e, G4double ekin) {
+  fPDG.push_back(pdg);
+  fPx.push_back(px);
+  fPy.push_back(py);
+  fPz.push_back(pz);
+  fE.push_back(e);
+  fEkin.push_back(ekin);
+}
+
+inline void SecondariesBuffer::CloseInteraction(G4int targetZ,
+                                                G4int targetA) {
+  fOffsets.push_back(fPDG.size());
+  fTargetZ.push_back(targetZ);
+  fTargetA.push_back(targetA);
+}
+
+#endif // SecondariesBuffer_h
+
+//**************************************************
@@ -0,0 +1,71 @@
+//**************************************************
+// \file SeedJournal.hh
+// \brief: Definition of SeedJournal class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+// Single append-only binary file holding the random engine state at the
+// start of each event, replacing one status file per event.
+// Records have a fixed size (event number and the CLHEP engine state as
+// returned by HepRandomEngine::put()), and are appended in the order the
+// events are sampled, which with several threads is not the event order.
+// At closing, an index of (event, offset) pairs sorted by event is
+// appended, so that a single event is restored with one binary search and
+// one seek. The journal of a run that did not close it (e.g. a crash) has
+// no index: it is rebuilt at reading by scanning the complete records.
+//
+// File layout (native endianness):
+// "G4HFSSJ1", uint64 state size (number of uint64 words), records of
+// uint64 event + state words, index of uint64 (event, offset) pairs,
+// uint64 index offset, uint64 number of records, "G4HFSSJE".
+
+#ifndef SeedJournal_h
+#define SeedJournal_h 1
+
+#include "globals.hh"
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace CLHEP {
+class HepRandomEngine;
+}
+
+class SeedJournal {
+public:
+  SeedJournal() = default;
+  ~SeedJournal() { Close(); }
+  SeedJournal(const SeedJournal &) = delete;
+  SeedJournal &operator=(const SeedJournal &) = delete;
+
+  // Writing: create the journal, append the engine state of an event
+  // (thread-safe), and write the index
+  //
+  G4bool OpenForWriting(const G4String &fileName,
+                        const CLHEP::HepRandomEngine &engine);
+  void Record(std::uint64_t event, const CLHEP::HepRandomEngine &engine);
+  void Close();
+
+  // Reading: load the index, and restore the engine state of an event
+  //
+  G4bool OpenForReading(const G4String &fileName);
+  G4bool Restore(std::uint64_t event, CLHEP::HepRandomEngine &engine);
+
+private:
+  G4bool ScanRecords();
+
+  std::fstream fFile;
+  G4bool fWriting = false;
+  std::uint64_t fStateSize = 0;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> fIndex;
+  std::vector<std::uint64_t> fRecord; // scratch record
+  std::mutex fMutex;
+};
+
+#endif // SeedJournal_h
+
+//**************************************************
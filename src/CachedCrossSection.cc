@@ -0,0 +1,361 @@
+//**************************************************
+// \file CachedCrossSection.cc
+// \brief: Implementation of CachedCrossSection class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "CachedCrossSection.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Element.hh"
+#include "G4Log.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Threading.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+// Tables: GetElementCrossSection, and ComputeCrossSectionPerElement (the
+// call of G4CrossSectionDataStore since Geant4 10.6), which a dataset may
+// implement differently
+//
+#if G4VERSION_NUMBER >= 1060
+const std::uint64_t nTables = 2;
+#else
+const std::uint64_t nTables = 1;
+#endif
+
+// Cache file layout (native endianness, every block 8-byte aligned):
+// Header, key (padded), nElements int32 Z (padded), nEnergies doubles,
+// nElements x nEnergies int32 applicable (padded), nTables x nElements x
+// nEnergies doubles
+//
+const char magic[8] = {'G', '4', 'H', 'F', 'S', 'X', 'S', '2'};
+struct Header {
+  char magic[8];
+  std::uint64_t keySize;
+  std::uint64_t nElements;
+  std::uint64_t nEnergies;
+  std::uint64_t nTables;
+};
+
+std::size_t Padded(std::size_t size) { return (size + 7) / 8 * 8; }
+
+void WritePadding(std::ofstream &file, std::size_t size) {
+  const char padding[8] = {};
+  file.write(padding, Padded(size) - size);
+}
+} // namespace
+
+CachedCrossSection::CachedCrossSection(G4VCrossSectionDataSet *dataSet,
+                                       const G4String &cacheDir,
+                                       const G4String &physicsCase,
+                                       const std::vector<G4double> &energies)
+    : G4VCrossSectionDataSet("Cached" + dataSet->GetName()), fDataSet(dataSet),
+      fParticle(nullptr), fDataSetBuilt(false), fCacheDir(cacheDir),
+      fPhysicsCase(physicsCase), fEnergies(energies), fApplicable(nullptr),
+      fXS(nullptr), fMapped(nullptr), fMappedSize(0) {
+  SetMinKinEnergy(dataSet->GetMinKinEnergy());
+  SetMaxKinEnergy(dataSet->GetMaxKinEnergy());
+  SetForceIsoFlag(dataSet->ForceIsoCrossSection());
+  std::sort(fEnergies.begin(), fEnergies.end());
+  fEnergies.erase(std::unique(fEnergies.begin(), fEnergies.end()),
+                  fEnergies.end());
+  for (G4double energy : fEnergies) {
+    fLogEnergies.push_back(G4Log(energy));
+  }
+}
+
+CachedCrossSection::~CachedCrossSection() {
+  if (fMapped != nullptr) {
+    munmap(fMapped, fMappedSize);
+  }
+}
+
+void CachedCrossSection::BuildPhysicsTable(
+    const G4ParticleDefinition &particle) {
+  fParticle = &particle;
+  fZ.clear();
+  fElements.clear();
+  for (const G4Element *element : *G4Element::GetElementTable()) {
+    if (std::find(fZ.begin(), fZ.end(), element->GetZasInt()) == fZ.end()) {
+      fZ.push_back(element->GetZasInt());
+      fElements.push_back(element);
+    }
+  }
+
+  const G4String key = BuildKey();
+  const G4String fileName = GetFileName(key);
+  if (!Load(fileName, key)) {
+    BuildDataSet();
+    Tabulate();
+    Write(fileName, key);
+  }
+  G4int maxZ = 0;
+  for (G4int Z : fZ) {
+    maxZ = std::max(maxZ, Z);
+  }
+  fTableIndex.assign(maxZ + 1, -1);
+  for (std::size_t i = 0; i < fZ.size(); i++) {
+    fTableIndex[fZ[i]] = static_cast<G4int>(i);
+  }
+}
+
+G4int CachedCrossSection::FindEntry(G4int Z, G4double kinEnergy) const {
+  if (Z < 0 || Z >= static_cast<G4int>(fTableIndex.size()) ||
+      fTableIndex[Z] < 0) {
+    return -1;
+  }
+  const auto energy =
+      std::lower_bound(fEnergies.begin(), fEnergies.end(), kinEnergy);
+  if (energy == fEnergies.end() || *energy != kinEnergy) {
+    return -1;
+  }
+  return fTableIndex[Z] * static_cast<G4int>(fEnergies.size()) +
+         static_cast<G4int>(energy - fEnergies.begin());
+}
+
+G4bool
+CachedCrossSection::IsElementApplicable(const G4DynamicParticle *particle,
+                                        G4int Z, const G4Material *material) {
+  const G4int entry = particle->GetDefinition() == fParticle
+                          ? FindEntry(Z, particle->GetKineticEnergy())
+                          : -1;
+  if (entry >= 0) {
+    return fApplicable[entry] != 0;
+  }
+  BuildDataSet();
+  return fDataSet->IsElementApplicable(particle, Z, material);
+}
+
+G4double
+CachedCrossSection::GetElementCrossSection(const G4DynamicParticle *particle,
+                                           G4int Z,
+                                           const G4Material *material) {
+  const G4int entry = particle->GetDefinition() == fParticle
+                          ? FindEntry(Z, particle->GetKineticEnergy())
+                          : -1;
+  if (entry >= 0) {
+    return fXS[entry];
+  }
+  BuildDataSet();
+  return fDataSet->GetElementCrossSection(particle, Z, material);
+}
+
+#if G4VERSION_NUMBER >= 1060
+G4double CachedCrossSection::ComputeCrossSectionPerElement(
+    G4double kinEnergy, G4double logE, const G4ParticleDefinition *particle,
+    const G4Element *element, const G4Material *material) {
+  const G4int Z = element->GetZasInt();
+  const G4int entry =
+      particle == fParticle ? FindEntry(Z, kinEnergy) : -1;
+  const std::size_t nEntries = fZ.size() * fEnergies.size();
+  if (entry >= 0 && fElements[fTableIndex[Z]] == element &&
+      fLogEnergies[entry % fEnergies.size()] == logE) {
+    return fXS[nEntries + entry];
+  }
+  BuildDataSet();
+  return fDataSet->ComputeCrossSectionPerElement(kinEnergy, logE, particle,
+                                                 element, material);
+}
+
+G4double CachedCrossSection::ComputeIsoCrossSection(
+    G4double kinEnergy, G4double logE, const G4ParticleDefinition *particle,
+    G4int Z, G4int A, const G4Isotope *isotope, const G4Element *element,
+    const G4Material *material) {
+  BuildDataSet();
+  return fDataSet->ComputeIsoCrossSection(kinEnergy, logE, particle, Z, A,
+                                          isotope, element, material);
+}
+#endif
+
+G4bool CachedCrossSection::IsIsoApplicable(const G4DynamicParticle *particle,
+                                           G4int Z, G4int A,
+                                           const G4Element *element,
+                                           const G4Material *material) {
+  BuildDataSet();
+  return fDataSet->IsIsoApplicable(particle, Z, A, element, material);
+}
+
+G4double CachedCrossSection::GetIsoCrossSection(
+    const G4DynamicParticle *particle, G4int Z, G4int A,
+    const G4Isotope *isotope, const G4Element *element,
+    const G4Material *material) {
+  BuildDataSet();
+  return fDataSet->GetIsoCrossSection(particle, Z, A, isotope, element,
+                                      material);
+}
+
+const G4Isotope *CachedCrossSection::SelectIsotope(const G4Element *element,
+                                                   G4double kinEnergy,
+                                                   G4double logE) {
+  BuildDataSet();
+  return fDataSet->SelectIsotope(element, kinEnergy, logE);
+}
+
+G4String CachedCrossSection::BuildKey() const {
+  std::ostringstream key;
+  key << G4Version << '|' << fPhysicsCase << '|'
+      << fParticle->GetParticleName() << '|' << fDataSet->GetName() << '|'
+      << nTables << "|Z";
+  for (G4int Z : fZ) {
+    key << ',' << Z;
+  }
+  key << "|E" << std::hexfloat;
+  for (G4double energy : fEnergies) {
+    key << ',' << energy;
+  }
+  return key.str();
+}
+
+G4String CachedCrossSection::GetFileName(const G4String &key) const {
+  std::ostringstream fileName;
+  fileName << fCacheDir << "/xs_" << fParticle->GetParticleName() << '_'
+           << std::hex << std::hash<std::string>()(key) << ".bin";
+  return fileName.str();
+}
+
+G4bool CachedCrossSection::Load(const G4String &fileName,
+                                const G4String &key) {
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 ||
+      static_cast<std::size_t>(fileStat.st_size) < sizeof(Header)) {
+    close(fd);
+    return false;
+  }
+  const std::size_t size = fileStat.st_size;
+  void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    return false;
+  }
+
+  // Check the key and the layout, any mismatch means a rebuild
+  //
+  const char *data = static_cast<const char *>(mapped);
+  Header header;
+  std::memcpy(&header, data, sizeof(Header));
+  const std::size_t nEntries = fZ.size() * fEnergies.size();
+  const std::size_t keyOffset = sizeof(Header);
+  const std::size_t elementsOffset = keyOffset + Padded(header.keySize);
+  const std::size_t energiesOffset =
+      elementsOffset + Padded(sizeof(std::int32_t) * fZ.size());
+  const std::size_t applicableOffset =
+      energiesOffset + sizeof(G4double) * fEnergies.size();
+  const std::size_t tableOffset =
+      applicableOffset + Padded(sizeof(std::int32_t) * nEntries);
+  const G4bool valid =
+      std::memcmp(header.magic, magic, sizeof(magic)) == 0 &&
+      header.keySize == key.size() && header.nElements == fZ.size() &&
+      header.nEnergies == fEnergies.size() && header.nTables == nTables &&
+      size == tableOffset + sizeof(G4double) * nTables * nEntries &&
+      std::memcmp(data + keyOffset, key.data(), key.size()) == 0 &&
+      std::memcmp(data + energiesOffset, fEnergies.data(),
+                  sizeof(G4double) * fEnergies.size()) == 0;
+  if (!valid) {
+    munmap(mapped, size);
+    G4cout << "CachedCrossSection: " << fileName
+           << " does not match, rebuilding" << G4endl;
+    return false;
+  }
+
+  fApplicableTable.clear();
+  fTable.clear();
+  fApplicable =
+      reinterpret_cast<const std::int32_t *>(data + applicableOffset);
+  fXS = reinterpret_cast<const G4double *>(data + tableOffset);
+  fMapped = mapped;
+  fMappedSize = size;
+  return true;
+}
+
+void CachedCrossSection::Tabulate() {
+  // The same calls, with the same arguments, as in the event loop
+  //
+  const std::size_t nEntries = fZ.size() * fEnergies.size();
+  G4DynamicParticle particle(fParticle, G4ThreeVector(0., 0., 1.), 1.);
+  fApplicableTable.assign(nEntries, 0);
+  fTable.assign(nTables * nEntries, 0.);
+  for (std::size_t i = 0; i < fZ.size(); i++) {
+    for (std::size_t j = 0; j < fEnergies.size(); j++) {
+      const std::size_t entry = i * fEnergies.size() + j;
+      particle.SetKineticEnergy(fEnergies[j]);
+      fApplicableTable[entry] =
+          fDataSet->IsElementApplicable(&particle, fZ[i]) ? 1 : 0;
+      fTable[entry] = fDataSet->GetElementCrossSection(&particle, fZ[i]);
+#if G4VERSION_NUMBER >= 1060
+      fTable[nEntries + entry] = fDataSet->ComputeCrossSectionPerElement(
+          fEnergies[j], fLogEnergies[j], fParticle, fElements[i], nullptr);
+#endif
+    }
+  }
+  fApplicable = fApplicableTable.data();
+  fXS = fTable.data();
+}
+
+void CachedCrossSection::Write(const G4String &fileName,
+                               const G4String &key) const {
+  // Write to a temporary file and rename it, so that concurrent jobs never
+  // map a partially written file
+  //
+  std::error_code error;
+  std::filesystem::create_directories(fCacheDir.c_str(), error);
+  std::ostringstream tmpName;
+  tmpName << fileName << ".tmp." << getpid() << '.'
+          << G4Threading::G4GetThreadId();
+  std::ofstream file(tmpName.str(), std::ios::binary);
+  if (!file) {
+    G4cerr << "CachedCrossSection: cannot write " << tmpName.str() << G4endl;
+    return;
+  }
+  Header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.keySize = key.size();
+  header.nElements = fZ.size();
+  header.nEnergies = fEnergies.size();
+  header.nTables = nTables;
+  file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+  file.write(key.data(), key.size());
+  WritePadding(file, key.size());
+  for (G4int Z : fZ) {
+    const std::int32_t element = Z;
+    file.write(reinterpret_cast<const char *>(&element), sizeof(element));
+  }
+  WritePadding(file, sizeof(std::int32_t) * fZ.size());
+  file.write(reinterpret_cast<const char *>(fEnergies.data()),
+             sizeof(G4double) * fEnergies.size());
+  file.write(reinterpret_cast<const char *>(fApplicableTable.data()),
+             sizeof(std::int32_t) * fApplicableTable.size());
+  WritePadding(file, sizeof(std::int32_t) * fApplicableTable.size());
+  file.write(reinterpret_cast<const char *>(fTable.data()),
+             sizeof(G4double) * fTable.size());
+  file.close();
+  if (!file || std::rename(tmpName.str().c_str(), fileName.c_str()) != 0) {
+    G4cerr << "CachedCrossSection: cannot write " << fileName << G4endl;
+    std::remove(tmpName.str().c_str());
+  }
+}
+
+void CachedCrossSection::BuildDataSet() {
+  if (!fDataSetBuilt) {
+    fDataSet->BuildPhysicsTable(*fParticle);
+    fDataSetBuilt = true;
+  }
+}
+
+//**************************************************
@@ -0,0 +1,60 @@
+//**************************************************
+// \file ConservationChecker.cc
+// \brief: Implementation of ConservationChecker class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "ConservationChecker.hh"
+#include "G4ios.hh"
+#include <algorithm>
+
+ConservationChecker::Delta ConservationChecker::EndEvent() {
+  const Delta delta{fE, fPx, fPy, fPz,
+                    static_cast<G4int>(std::lround(fCharge)), fBaryonNumber};
+  const G4double energyDelta = std::abs(fE);
+  const G4double momentumDelta = std::sqrt(fPx * fPx + fPy * fPy + fPz * fPz);
+  fEvents++;
+  fEnergyViolations += energyDelta > fEnergyTolerance;
+  fMomentumViolations += momentumDelta > fMomentumTolerance;
+  fChargeViolations += delta.charge != 0;
+  fBaryonViolations += delta.baryonNumber != 0;
+  fMaxEnergyDelta = std::max(fMaxEnergyDelta, energyDelta);
+  fMaxMomentumDelta = std::max(fMaxMomentumDelta, momentumDelta);
+  return delta;
+}
+
+void ConservationChecker::Merge(const ConservationChecker &other) {
+  fEvents += other.fEvents;
+  fEnergyViolations += other.fEnergyViolations;
+  fMomentumViolations += other.fMomentumViolations;
+  fChargeViolations += other.fChargeViolations;
+  fBaryonViolations += other.fBaryonViolations;
+  fMaxEnergyDelta = std::max(fMaxEnergyDelta, other.fMaxEnergyDelta);
+  fMaxMomentumDelta = std::max(fMaxMomentumDelta, other.fMaxMomentumDelta);
+}
+
+void ConservationChecker::Clear() {
+  fEvents = 0;
+  fEnergyViolations = 0;
+  fMomentumViolations = 0;
+  fChargeViolations = 0;
+  fBaryonViolations = 0;
+  fMaxEnergyDelta = 0.;
+  fMaxMomentumDelta = 0.;
+}
+
+void ConservationChecker::Print() const {
+  G4cout << "=== Conservation over " << fEvents << " events ===" << G4endl
+         << "energy   |dE| > " << fEnergyTolerance / CLHEP::MeV
+         << " MeV: " << fEnergyViolations << " (max "
+         << fMaxEnergyDelta / CLHEP::MeV << " MeV)" << G4endl
+         << "momentum |dp| > " << fMomentumTolerance / CLHEP::MeV
+         << " MeV: " << fMomentumViolations << " (max "
+         << fMaxMomentumDelta / CLHEP::MeV << " MeV)" << G4endl
+         << "charge   dQ != 0: " << fChargeViolations << G4endl
+         << "baryon   dB != 0: " << fBaryonViolations << G4endl;
+}
+
+//**************************************************
@@ -0,0 +1,52 @@
+//**************************************************
+// \file CrossSectionTable.cc
+// \brief: Implementation of CrossSectionTable class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "CrossSectionTable.hh"
+
+CrossSectionTable::CrossSectionTable(G4double minEnergy, G4double maxEnergy,
+                                     G4int pointsPerDecade)
+    : fLogMinEnergy(std::log(minEnergy)),
+      fInvLogStep(pointsPerDecade / std::log(10.)) {
+  const std::size_t nPoints =
+      std::max<std::size_t>(
+          2, static_cast<std::size_t>(std::ceil(
+                 std::log10(maxEnergy / minEnergy) * pointsPerDecade)) +
+                 1);
+  fMaxIndex = static_cast<G4double>(nPoints - 1);
+  fValues.assign(nPoints, 0.);
+}
+
+G4double CrossSectionTable::GetEnergy(std::size_t i) const {
+  return std::exp(fLogMinEnergy + i / fInvLogStep);
+}
+
+void CrossSectionTable::Add(const CrossSectionTable &table, G4double weight) {
+  for (std::size_t i = 0; i < fValues.size(); i++) {
+    fValues[i] += weight * table.fValues[i];
+  }
+}
+
+void CrossSectionTable::Evaluate(const G4double *energies, std::size_t n,
+                                 G4double *values) const {
+  // Two passes: the logarithms first (a loop the compiler can vectorize
+  // with a vector math library), then the interpolation
+  //
+  for (std::size_t k = 0; k < n; k++) {
+    values[k] = std::log(energies[k]);
+  }
+  const G4double *table = fValues.data();
+  const std::size_t maxInterval = fValues.size() - 2;
+  for (std::size_t k = 0; k < n; k++) {
+    const G4double u = std::min(
+        std::max((values[k] - fLogMinEnergy) * fInvLogStep, 0.), fMaxIndex);
+    const std::size_t i = std::min(static_cast<std::size_t>(u), maxInterval);
+    values[k] = table[i] + (u - i) * (table[i + 1] - table[i]);
+  }
+}
+
+//**************************************************
@@ -0,0 +1,126 @@
+//**************************************************
+// \file EarlyStop.cc
+// \brief: Implementation of Welford and EarlyStop classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "EarlyStop.hh"
+#include "G4ios.hh"
+#include <limits>
+
+void Welford::Merge(const Welford &other) {
+  if (other.fN == 0) {
+    return;
+  }
+  const std::uint64_t n = fN + other.fN;
+  const G4double delta = other.fMean - fMean;
+  fMean += delta * other.fN / n;
+  fM2 += other.fM2 + delta * delta * fN * other.fN / n;
+  fN = n;
+}
+
+G4double Welford::GetRelativeError() const {
+  if (fN < 2 || fMean == 0.) {
+    return std::numeric_limits<G4double>::infinity();
+  }
+  return std::sqrt(GetVariance() / fN) / std::abs(fMean);
+}
+
+EarlyStop::EarlyStop(const std::vector<G4String> &observables,
+                     G4int nThreads)
+    : fObservables(observables), fTargets(observables.size(), 0.),
+      fSnapshots(nThreads, std::vector<Welford>(observables.size())) {}
+
+G4bool EarlyStop::SetTarget(const G4String &observable,
+                            G4double relativeError) {
+  for (std::size_t i = 0; i < fObservables.size(); i++) {
+    if (fObservables[i] == observable) {
+      fTargets[i] = relativeError;
+      return true;
+    }
+  }
+  return false;
+}
+
+G4bool EarlyStop::IsActive() const {
+  if (fTimeBudget > 0.) {
+    return true;
+  }
+  for (G4double target : fTargets) {
+    if (target > 0.) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void EarlyStop::Start() {
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (auto &snapshot : fSnapshots) {
+    snapshot.assign(fObservables.size(), Welford());
+  }
+  fReason = "requested number of events";
+  fStop.store(false, std::memory_order_relaxed);
+  fStart = std::chrono::steady_clock::now();
+}
+
+std::vector<Welford> EarlyStop::Merged() const {
+  std::vector<Welford> merged(fObservables.size());
+  for (const auto &snapshot : fSnapshots) {
+    for (std::size_t i = 0; i < merged.size(); i++) {
+      merged[i].Merge(snapshot[i]);
+    }
+  }
+  return merged;
+}
+
+void EarlyStop::Update(G4int thread, const std::vector<Welford> &stats) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  fSnapshots[thread] = stats;
+  if (ShouldStop()) {
+    return;
+  }
+  const std::chrono::duration<G4double> elapsed =
+      std::chrono::steady_clock::now() - fStart;
+  if (fTimeBudget > 0. && elapsed.count() >= fTimeBudget) {
+    fReason = "time budget";
+    fStop.store(true, std::memory_order_relaxed);
+    return;
+  }
+  const std::vector<Welford> merged = Merged();
+  G4bool reached = false;
+  for (std::size_t i = 0; i < merged.size(); i++) {
+    if (fTargets[i] > 0.) {
+      if (merged[i].GetRelativeError() > fTargets[i]) {
+        return;
+      }
+      reached = true;
+    }
+  }
+  if (reached) {
+    fReason = "target precision";
+    fStop.store(true, std::memory_order_relaxed);
+  }
+}
+
+void EarlyStop::Print() const {
+  std::lock_guard<std::mutex> lock(fMutex);
+  const std::vector<Welford> merged = Merged();
+  const std::chrono::duration<G4double> elapsed =
+      std::chrono::steady_clock::now() - fStart;
+  G4cout << "Events with an interaction: "
+         << (merged.empty() ? 0 : merged[0].GetN()) << " in "
+         << elapsed.count() << " s, stopped on: " << fReason << G4endl;
+  for (std::size_t i = 0; i < merged.size(); i++) {
+    G4cout << "  mean " << fObservables[i] << ": " << merged[i].GetMean()
+           << " +- " << merged[i].GetRelativeError() * 100. << " %";
+    if (fTargets[i] > 0.) {
+      G4cout << " (target " << fTargets[i] * 100. << " %)";
+    }
+    G4cout << G4endl;
+  }
+}
+
+//**************************************************
@@ -0,0 +1,238 @@
+//**************************************************
+// \file EnergySpectrum.cc
+// \brief: Implementation of EnergySpectrum class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "EnergySpectrum.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+std::vector<G4String> SplitFields(const G4String &value) {
+  std::vector<G4String> fields;
+  std::stringstream stream(value);
+  std::string field;
+  while (std::getline(stream, field, ':')) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+G4bool ToDouble(const G4String &value, G4double &result) {
+  char *end = nullptr;
+  result = std::strtod(value.c_str(), &end);
+  return !value.empty() && *end == '\0';
+}
+
+// Integral of E^-gamma over [a, b]
+//
+G4double PowerLawIntegral(G4double a, G4double b, G4double gamma) {
+  if (std::abs(gamma - 1.) < 1e-9) {
+    return std::log(b / a);
+  }
+  const G4double g = 1. - gamma;
+  return (std::pow(b, g) - std::pow(a, g)) / g;
+}
+} // namespace
+
+G4bool EnergySpectrum::Build(const G4String &description) {
+  const std::vector<G4String> fields = SplitFields(description);
+  if (fields.empty()) {
+    G4cerr << "EnergySpectrum: empty spectrum description" << G4endl;
+    return false;
+  }
+  G4double minEnergy = 0.;
+  G4double maxEnergy = 0.;
+  G4double gamma = 0.;
+  const G4bool rangeOk = fields.size() >= 3 && ToDouble(fields[1], minEnergy) &&
+                         ToDouble(fields[2], maxEnergy);
+  G4bool built = false;
+  if (fields[0] == "flat" && fields.size() == 3 && rangeOk) {
+    built = BuildPowerLaw(minEnergy, maxEnergy, 0.);
+  } else if (fields[0] == "logflat" && fields.size() == 3 && rangeOk) {
+    built = BuildPowerLaw(minEnergy, maxEnergy, 1.);
+  } else if (fields[0] == "power" && fields.size() == 4 && rangeOk &&
+             ToDouble(fields[3], gamma)) {
+    built = BuildPowerLaw(minEnergy, maxEnergy, gamma);
+  } else if (fields.size() == 1) {
+    built = BuildTabulated(description);
+  }
+  if (!built) {
+    G4cerr << "EnergySpectrum: cannot build the spectrum " << description
+           << G4endl;
+    return false;
+  }
+  if (fTabulated) {
+    const std::size_t slash = description.find_last_of('/');
+    const G4String base = description.substr(
+        slash == std::string::npos ? 0 : slash + 1);
+    fLabel = base.substr(0, base.find('.'));
+  } else {
+    std::ostringstream label;
+    label << fields[0] << fields[1] << "-" << fields[2];
+    if (fields.size() == 4) {
+      label << "-" << fields[3];
+    }
+    fLabel = label.str();
+  }
+  return true;
+}
+
+G4bool EnergySpectrum::BuildPowerLaw(G4double minEnergy, G4double maxEnergy,
+                                     G4double gamma) {
+  // Flat spectra may start at 0, the others need log bins
+  //
+  const G4bool logBins = gamma != 0.;
+  if (maxEnergy <= minEnergy || minEnergy < 0. ||
+      (logBins && minEnergy <= 0.)) {
+    return false;
+  }
+  fTabulated = false;
+  fGamma = gamma;
+  fEdges.resize(nPowerLawBins + 1);
+  for (std::size_t i = 0; i <= nPowerLawBins; i++) {
+    const G4double fraction = static_cast<G4double>(i) / nPowerLawBins;
+    fEdges[i] = logBins ? minEnergy * std::pow(maxEnergy / minEnergy, fraction)
+                        : minEnergy + (maxEnergy - minEnergy) * fraction;
+  }
+  fEdges.back() = maxEnergy;
+  std::vector<G4double> weights(nPowerLawBins);
+  for (std::size_t i = 0; i < nPowerLawBins; i++) {
+    weights[i] = PowerLawIntegral(fEdges[i], fEdges[i + 1], gamma);
+  }
+  for (G4double &edge : fEdges) {
+    edge *= CLHEP::GeV;
+  }
+  BuildAliasTable(weights);
+  return true;
+}
+
+G4bool EnergySpectrum::BuildTabulated(const G4String &fileName) {
+  std::ifstream file(fileName);
+  if (!file) {
+    return false;
+  }
+  fEdges.clear();
+  fDensity.clear();
+  std::string line;
+  while (std::getline(file, line)) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    G4double energy = 0.;
+    G4double density = 0.;
+    if (!(fields >> energy)) {
+      continue; // empty or comment line
+    }
+    if (!(fields >> density) || density < 0. ||
+        (!fEdges.empty() && energy <= fEdges.back())) {
+      return false;
+    }
+    fEdges.push_back(energy);
+    fDensity.push_back(density);
+  }
+  if (fEdges.size() < 2) {
+    return false;
+  }
+  fTabulated = true;
+  std::vector<G4double> weights(fEdges.size() - 1);
+  G4double total = 0.;
+  for (std::size_t i = 0; i + 1 < fEdges.size(); i++) {
+    weights[i] = 0.5 * (fDensity[i] + fDensity[i + 1]) *
+                 (fEdges[i + 1] - fEdges[i]);
+    total += weights[i];
+  }
+  if (total <= 0.) {
+    return false;
+  }
+  for (G4double &edge : fEdges) {
+    edge *= CLHEP::GeV;
+  }
+  BuildAliasTable(weights);
+  return true;
+}
+
+void EnergySpectrum::BuildAliasTable(const std::vector<G4double> &weights) {
+  // Vose's method: bins with a scaled probability below 1 are topped up by
+  // the bins above 1, each bin ends up with at most one alias
+  //
+  const std::size_t n = weights.size();
+  G4double total = 0.;
+  for (G4double weight : weights) {
+    total += weight;
+  }
+  fProbability.resize(n);
+  fAlias.resize(n);
+  std::vector<std::size_t> small;
+  std::vector<std::size_t> large;
+  for (std::size_t i = 0; i < n; i++) {
+    fProbability[i] = weights[i] * n / total;
+    fAlias[i] = i;
+    (fProbability[i] < 1. ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    const std::size_t less = small.back();
+    small.pop_back();
+    const std::size_t more = large.back();
+    fAlias[less] = more;
+    fProbability[more] -= 1. - fProbability[less];
+    if (fProbability[more] < 1.) {
+      large.pop_back();
+      small.push_back(more);
+    }
+  }
+  // Left-overs are 1 up to rounding
+  //
+  for (std::size_t i : small) {
+    fProbability[i] = 1.;
+  }
+  for (std::size_t i : large) {
+    fProbability[i] = 1.;
+  }
+}
+
+G4double EnergySpectrum::SampleInBin(std::size_t bin, G4double u) const {
+  const G4double a = fEdges[bin];
+  const G4double b = fEdges[bin + 1];
+  if (fTabulated) {
+    // Inverse of the cumulative of the linear density within the bin
+    //
+    const G4double f0 = fDensity[bin];
+    const G4double f1 = fDensity[bin + 1];
+    const G4double slope = f1 - f0;
+    G4double t = u;
+    if (std::abs(slope) > 1e-12 * (f0 + f1)) {
+      t = (-f0 + std::sqrt(f0 * f0 + slope * u * (f0 + f1))) / slope;
+    }
+    return a + t * (b - a);
+  }
+  if (fGamma == 0.) {
+    return a + u * (b - a);
+  }
+  if (std::abs(fGamma - 1.) < 1e-9) {
+    return a * std::pow(b / a, u);
+  }
+  const G4double g = 1. - fGamma;
+  return std::pow(std::pow(a, g) + u * (std::pow(b, g) - std::pow(a, g)),
+                  1. / g);
+}
+
+G4double EnergySpectrum::Sample() const {
+  const std::size_t n = fProbability.size();
+  std::size_t bin = std::min(static_cast<std::size_t>(G4UniformRand() * n),
+                             n - 1);
+  if (G4UniformRand() >= fProbability[bin]) {
+    bin = fAlias[bin];
+  }
+  return SampleInBin(bin, G4UniformRand());
+}
+
+//**************************************************
@@ -0,0 +1,183 @@
+//**************************************************
+// \file EventWriter.cc
+// \brief: Implementation of EventWriter and EventBuffer classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "EventWriter.hh"
+#include "G4ios.hh"
+#include <cstdio>
+
+namespace {
+template <typename T> void AppendValue(std::string &buffer, const T &value) {
+  buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// PDG code of a nucleus, 100ZZZAAA0, a proton for hydrogen
+//
+std::int32_t NucleusPDG(G4int Z, G4int A) {
+  if (Z == 1 && A == 1) {
+    return 2212;
+  }
+  return 1000000000 + Z * 10000 + A * 10;
+}
+} // namespace
+
+EventWriter::~EventWriter() { Close(); }
+
+G4bool EventWriter::Open(const G4String &fileName, Format format,
+                         const G4String &metadata) {
+  fFile.open(fileName, std::ios::binary | std::ios::trunc);
+  if (!fFile) {
+    G4cerr << "EventWriter: cannot open " << fileName << G4endl;
+    return false;
+  }
+  fFormat = format;
+  if (fFormat == Format::HepMC3) {
+    fFile << "HepMC::Version 3.02.06\n"
+          << "HepMC::Asciiv3-START_EVENT_LISTING\n"
+          << "T G4HadFSGenerator\\|1\\|" << metadata << "\n";
+  } else {
+    fFile.write("G4HFSEV1", 8);
+    const std::uint32_t size = static_cast<std::uint32_t>(metadata.size());
+    fFile.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    fFile.write(metadata.data(), metadata.size());
+  }
+  fClosing = false;
+  fThread = std::thread(&EventWriter::WriteLoop, this);
+  return true;
+}
+
+void EventWriter::Close() {
+  if (!fThread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fClosing = true;
+  }
+  fCondition.notify_one();
+  fThread.join();
+  if (fFormat == Format::HepMC3) {
+    fFile << "HepMC::Asciiv3-END_EVENT_LISTING\n";
+  } else {
+    const std::uint32_t end = 0;
+    fFile.write(reinterpret_cast<const char *>(&end), sizeof(end));
+    fFile.write("END!", 4);
+  }
+  fFile.close();
+}
+
+std::unique_ptr<std::string> EventWriter::GetBuffer() {
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fFreeBuffers.empty()) {
+      std::unique_ptr<std::string> buffer = std::move(fFreeBuffers.back());
+      fFreeBuffers.pop_back();
+      return buffer;
+    }
+  }
+  std::unique_ptr<std::string> buffer(new std::string);
+  buffer->reserve(bufferBytes + (bufferBytes >> 2));
+  return buffer;
+}
+
+void EventWriter::Submit(std::unique_ptr<std::string> buffer) {
+  {
+    std::unique_lock<std::mutex> lock(fMutex);
+    fSpace.wait(lock, [&] { return fQueue.size() < maxQueuedBuffers; });
+    fQueue.push_back(std::move(buffer));
+  }
+  fCondition.notify_one();
+}
+
+void EventWriter::WriteLoop() {
+  std::unique_lock<std::mutex> lock(fMutex);
+  while (true) {
+    fCondition.wait(lock, [&] { return fClosing || !fQueue.empty(); });
+    if (fQueue.empty()) {
+      return; // closing and nothing left to write
+    }
+    std::unique_ptr<std::string> buffer = std::move(fQueue.front());
+    fQueue.pop_front();
+    lock.unlock();
+    fSpace.notify_all();
+    fFile.write(buffer->data(), buffer->size());
+    buffer->clear();
+    lock.lock();
+    fFreeBuffers.push_back(std::move(buffer));
+  }
+}
+
+void EventBuffer::BeginEvent(std::uint64_t event, std::int32_t projectilePDG,
+                             G4double px, G4double py, G4double pz,
+                             G4double e, G4double m, G4int targetZ,
+                             G4int targetA, G4double targetMass) {
+  fEvent = event;
+  fParticles.clear();
+  fParticles.push_back({projectilePDG, 4, px / CLHEP::GeV, py / CLHEP::GeV,
+                        pz / CLHEP::GeV, e / CLHEP::GeV, m / CLHEP::GeV});
+  fParticles.push_back({NucleusPDG(targetZ, targetA), 4, 0., 0., 0.,
+                        targetMass / CLHEP::GeV, targetMass / CLHEP::GeV});
+}
+
+void EventBuffer::EndEvent() {
+  if (fFormat == EventWriter::Format::HepMC3) {
+    FormatHepMC3();
+  } else {
+    FormatBinary();
+  }
+  if (fBuffer->size() >= EventWriter::bufferBytes) {
+    Flush();
+  }
+}
+
+void EventBuffer::Flush() {
+  if (fBuffer != nullptr && !fBuffer->empty()) {
+    fWriter->Submit(std::move(fBuffer));
+    fBuffer = fWriter->GetBuffer();
+  }
+}
+
+void EventBuffer::FormatHepMC3() {
+  char line[256];
+  std::string &buffer = *fBuffer;
+  std::snprintf(line, sizeof(line), "E %llu 1 %zu\nU GEV MM\n",
+                static_cast<unsigned long long>(fEvent), fParticles.size());
+  buffer += line;
+  for (std::size_t i = 0; i < fParticles.size(); i++) {
+    const Particle &particle = fParticles[i];
+    std::snprintf(line, sizeof(line),
+                  "P %zu %d %d %.16e %.16e %.16e %.16e %.16e %d\n", i + 1,
+                  particle.status == 4 ? 0 : -1, particle.pdg, particle.px,
+                  particle.py, particle.pz, particle.e, particle.m,
+                  particle.status);
+    buffer += line;
+    if (i == 1) {
+      buffer += "V -1 0 [1,2]\n";
+    }
+  }
+}
+
+void EventBuffer::FormatBinary() {
+  std::string &buffer = *fBuffer;
+  const std::uint32_t size = static_cast<std::uint32_t>(
+      sizeof(std::uint64_t) + sizeof(std::uint32_t) +
+      fParticles.size() * (2 * sizeof(std::int32_t) + 5 * sizeof(G4double)));
+  AppendValue(buffer, size);
+  AppendValue(buffer, fEvent);
+  AppendValue(buffer, static_cast<std::uint32_t>(fParticles.size()));
+  for (const Particle &particle : fParticles) {
+    AppendValue(buffer, particle.pdg);
+    AppendValue(buffer, particle.status);
+    AppendValue(buffer, particle.px);
+    AppendValue(buffer, particle.py);
+    AppendValue(buffer, particle.pz);
+    AppendValue(buffer, particle.e);
+    AppendValue(buffer, particle.m);
+  }
+}
+
+//**************************************************
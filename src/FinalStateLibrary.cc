@@ -0,0 +1,276 @@
+//**************************************************
+// \file FinalStateLibrary.cc
+// \brief: Implementation of FinalStateLibraryWriter and FinalStateLibrary
+//         classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "FinalStateLibrary.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+const char magic[8] = {'G', '4', 'H', 'F', 'S', 'F', 'L', '1'};
+
+std::size_t Padded(std::size_t size) { return (size + 7) & ~std::size_t(7); }
+
+void WritePadding(std::ofstream &file, std::size_t size) {
+  const char padding[8] = {};
+  file.write(padding, Padded(size) - size);
+}
+
+// Velocity of the centre of mass of a projectile of kinetic energy energy
+// and a target at rest
+//
+G4double CentreOfMassBeta(G4double energy, G4double projectileMass,
+                          G4double targetMass) {
+  const G4double momentum =
+      std::sqrt(energy * (energy + 2. * projectileMass));
+  return momentum / (energy + projectileMass + targetMass);
+}
+} // namespace
+
+void FinalStateLibraryWriter::BeginInteraction(std::int32_t projectilePDG,
+                                               G4double energy,
+                                               G4int targetZ,
+                                               G4double projectileMass,
+                                               G4double targetMass) {
+  auto key = std::make_tuple(projectilePDG, std::int32_t(targetZ), energy);
+  auto entry = fBins.find(key);
+  if (entry == fBins.end()) {
+    BinData data;
+    data.bin = {projectilePDG, targetZ, energy, projectileMass, targetMass,
+                0, 0, 0, 0};
+    entry = fBins.emplace(key, std::move(data)).first;
+  }
+  fCurrent = &entry->second;
+  fCurrent->bin.nInteractions++;
+  fCurrent->offsets.push_back(fCurrent->offsets.back());
+}
+
+G4bool FinalStateLibraryWriter::Write(const G4String &fileName,
+                                      const G4String &metadata) const {
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    G4cerr << "FinalStateLibraryWriter: cannot open " << fileName << G4endl;
+    return false;
+  }
+  fslib::Header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.metadataSize = metadata.size();
+  header.nBins = fBins.size();
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(metadata.data(), metadata.size());
+  WritePadding(file, metadata.size());
+
+  // Bins in key order, which is the order of the index
+  //
+  std::vector<fslib::Bin> index;
+  std::uint64_t offset = sizeof(header) + Padded(metadata.size());
+  for (const auto &entry : fBins) {
+    const BinData &data = entry.second;
+    fslib::Bin bin = data.bin;
+    bin.nSecondaries = data.secondaries.size();
+    bin.offsetsOffset = offset;
+    const std::size_t offsetsSize =
+        sizeof(std::uint32_t) * data.offsets.size();
+    file.write(reinterpret_cast<const char *>(data.offsets.data()),
+               offsetsSize);
+    WritePadding(file, offsetsSize);
+    offset += Padded(offsetsSize);
+    bin.secondariesOffset = offset;
+    const std::size_t secondariesSize =
+        sizeof(fslib::Secondary) * data.secondaries.size();
+    file.write(reinterpret_cast<const char *>(data.secondaries.data()),
+               secondariesSize);
+    WritePadding(file, secondariesSize);
+    offset += Padded(secondariesSize);
+    index.push_back(bin);
+  }
+  file.write(reinterpret_cast<const char *>(index.data()),
+             sizeof(fslib::Bin) * index.size());
+
+  // Index offset, known only now
+  //
+  header.indexOffset = offset;
+  file.seekp(0);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.close();
+  if (!file) {
+    G4cerr << "FinalStateLibraryWriter: cannot write " << fileName << G4endl;
+    return false;
+  }
+  return true;
+}
+
+G4bool FinalStateLibrary::Open(const G4String &fileName) {
+  Close();
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    G4cerr << "FinalStateLibrary: cannot open " << fileName << G4endl;
+    return false;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 ||
+      static_cast<std::size_t>(fileStat.st_size) < sizeof(fslib::Header)) {
+    close(fd);
+    G4cerr << "FinalStateLibrary: " << fileName << " is too short" << G4endl;
+    return false;
+  }
+  const std::size_t size = fileStat.st_size;
+  void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    G4cerr << "FinalStateLibrary: cannot map " << fileName << G4endl;
+    return false;
+  }
+  const char *data = static_cast<const char *>(mapped);
+  fslib::Header header;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+      header.indexOffset + sizeof(fslib::Bin) * header.nBins != size) {
+    munmap(mapped, size);
+    G4cerr << "FinalStateLibrary: " << fileName << " is not a library"
+           << G4endl;
+    return false;
+  }
+  fData = data;
+  fSize = size;
+  fBins = reinterpret_cast<const fslib::Bin *>(data + header.indexOffset);
+  fNBins = header.nBins;
+  return true;
+}
+
+void FinalStateLibrary::Close() {
+  if (fData != nullptr) {
+    munmap(const_cast<char *>(fData), fSize);
+  }
+  fData = nullptr;
+  fSize = 0;
+  fBins = nullptr;
+  fNBins = 0;
+}
+
+G4String FinalStateLibrary::GetMetadata() const {
+  if (fData == nullptr) {
+    return "";
+  }
+  fslib::Header header;
+  std::memcpy(&header, fData, sizeof(header));
+  return G4String(fData + sizeof(header), header.metadataSize);
+}
+
+const fslib::Bin *FinalStateLibrary::FindBin(G4int projectilePDG,
+                                             G4int targetZ,
+                                             G4double energy) const {
+  // Bins of the projectile and element are contiguous and sorted by energy
+  //
+  const fslib::Bin *end = fBins + fNBins;
+  const fslib::Bin *first = std::lower_bound(
+      fBins, end, std::make_pair(projectilePDG, targetZ),
+      [](const fslib::Bin &bin, const std::pair<G4int, G4int> &key) {
+        return std::make_pair(bin.projectilePDG, bin.targetZ) < key;
+      });
+  const fslib::Bin *last = first;
+  while (last != end && last->projectilePDG == projectilePDG &&
+         last->targetZ == targetZ) {
+    last++;
+  }
+  if (first == last) {
+    return nullptr;
+  }
+  const fslib::Bin *above = std::lower_bound(
+      first, last, energy,
+      [](const fslib::Bin &bin, G4double value) { return bin.energy < value; });
+  if (above == first) {
+    return first;
+  }
+  if (above == last) {
+    return last - 1;
+  }
+  const fslib::Bin *below = above - 1;
+  return std::log(energy / below->energy) < std::log(above->energy / energy)
+             ? below
+             : above;
+}
+
+FinalStateLibrary::Interaction
+FinalStateLibrary::GetInteraction(const fslib::Bin &bin,
+                                  std::size_t i) const {
+  const std::uint32_t *offsets =
+      reinterpret_cast<const std::uint32_t *>(fData + bin.offsetsOffset);
+  const fslib::Secondary *secondaries =
+      reinterpret_cast<const fslib::Secondary *>(fData +
+                                                 bin.secondariesOffset);
+  return {&bin, secondaries + offsets[i], offsets[i + 1] - offsets[i]};
+}
+
+FinalStateLibrary::Interaction
+FinalStateLibrary::Sample(G4int projectilePDG, G4int targetZ,
+                          G4double energy,
+                          CLHEP::HepRandomEngine &engine) const {
+  const fslib::Bin *bin = FindBin(projectilePDG, targetZ, energy);
+  if (bin == nullptr || bin->nInteractions == 0) {
+    return {nullptr, nullptr, 0};
+  }
+  const std::size_t i = std::min<std::size_t>(
+      engine.flat() * bin->nInteractions, bin->nInteractions - 1);
+  return GetInteraction(*bin, i);
+}
+
+void FinalStateLibrary::Replay(const Interaction &interaction,
+                               const G4ThreeVector &direction,
+                               G4double energy, G4bool boost,
+                               CLHEP::HepRandomEngine &engine,
+                               std::vector<Particle> &particles) const {
+  particles.clear();
+  if (interaction.bin == nullptr) {
+    return;
+  }
+  const fslib::Bin &bin = *interaction.bin;
+  const G4double phi = CLHEP::twopi * engine.flat();
+  const G4double cosPhi = std::cos(phi);
+  const G4double sinPhi = std::sin(phi);
+
+  // Boost along the axis: from the centre of mass of the bin energy to the
+  // laboratory frame of the requested one (velocity addition)
+  //
+  G4double beta = 0.;
+  if (boost && energy != bin.energy) {
+    const G4double betaBin =
+        CentreOfMassBeta(bin.energy, bin.projectileMass, bin.targetMass);
+    const G4double betaNew =
+        CentreOfMassBeta(energy, bin.projectileMass, bin.targetMass);
+    beta = (betaNew - betaBin) / (1. - betaNew * betaBin);
+  }
+  const G4double gamma = 1. / std::sqrt(1. - beta * beta);
+
+  const G4ThreeVector axis = direction.unit();
+  for (std::size_t i = 0; i < interaction.nSecondaries; i++) {
+    const fslib::Secondary &secondary = interaction.secondaries[i];
+    G4double pz = secondary.pz;
+    G4double e = secondary.e;
+    if (beta != 0.) {
+      pz = gamma * (secondary.pz + beta * secondary.e);
+      e = gamma * (secondary.e + beta * secondary.pz);
+    }
+    G4ThreeVector momentum(cosPhi * secondary.px - sinPhi * secondary.py,
+                           sinPhi * secondary.px + cosPhi * secondary.py, pz);
+    momentum.rotateUz(axis);
+    particles.push_back({secondary.pdg, G4LorentzVector(momentum, e)});
+  }
+}
+
+//**************************************************
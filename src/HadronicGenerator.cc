@@ -37,11 +37,15 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "HadronicGenerator.hh"
+#include "CachedCrossSection.hh"
+#include "InteractionProfiler.hh"
+#include "SecondariesBuffer.hh"
 #include <iomanip>
 #include "globals.hh"
 #include "G4ios.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4Material.hh"
+#include "G4NistManager.hh"
 #include "G4ProcessManager.hh"
 #include "G4VParticleChange.hh"
 #include "G4ParticleTable.hh"
@@ -154,21 +158,46 @@
 #include "G4ComponentAntiNuclNuclearXS.hh"
 #include "G4ComponentGGNuclNuclXsc.hh"
 
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HadronicGenerator::PhysicsCase HadronicGenerator::ToPhysicsCase( const G4String &physicsCase ) {
+  static const std::map< G4String, PhysicsCase > physicsCases = {
+    { "FTFP_BERT_ATL", PhysicsCase::FTFP_BERT_ATL }, { "FTFP_BERT", PhysicsCase::FTFP_BERT },
+    { "QGSP_BERT", PhysicsCase::QGSP_BERT }, { "QGSP_BIC", PhysicsCase::QGSP_BIC },
+    { "FTFP_INCLXX", PhysicsCase::FTFP_INCLXX }, { "BERT", PhysicsCase::BERT },
+    { "BIC", PhysicsCase::BIC }, { "IonBIC", PhysicsCase::IonBIC }, { "INCL", PhysicsCase::INCL },
+    { "FTFP", PhysicsCase::FTFP }, { "QGSP", PhysicsCase::QGSP } };
+  auto caseIndex = physicsCases.find( physicsCase );
+  return caseIndex != physicsCases.end() ? caseIndex->second : PhysicsCase::Unsupported;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 HadronicGenerator::HadronicGenerator( const G4String physicsCase ) :
-  fPhysicsCase( physicsCase ), fPhysicsCaseIsSupported( false ),
-  fLastHadronicProcess( nullptr ), fPartTable( nullptr )
+  fPhysicsCase( physicsCase ), fPhysicsCaseId( ToPhysicsCase( physicsCase ) ),
+  fPhysicsCaseIsSupported( false ),
+  fLastHadronicProcess( nullptr ), fLastChange( nullptr ), fLastProjectile( nullptr ), fLastProjectileIndex( -1 ),
+  fLastProcessIndex( -1 ), fPartTable( nullptr ),
+  fDynamicParticle( nullptr ), fTrack( nullptr ), fStep( nullptr ),
+  fPreEquilib( nullptr ), fPrecoInterface( nullptr ), fFTFStringModel( nullptr ),
+  fProfiler( nullptr )
 {
-  // The constructor set-ups all the particles, models, cross sections and
-  // hadronic inelastic processes.
+  // The constructor set-ups all the particles, and the table of the projectiles
+  // with their hadronic inelastic process, cross sections and hadronic models.
   // This should be done only once for each application.
   // In the case of a multi-threaded application using this class,
   // the constructor should be invoked for each thread,
   // i.e. one instance of the class should be kept per thread.
-  // The particles and processes that are created in this constructor
-  // will then be used by the method GenerateInteraction at each interaction.
+  // The hadronic models, cross sections and hadronic inelastic processes are
+  // instead created on demand, the first time a projectile is requested (see
+  // PrepareProjectile), and only those needed by the physics case for that
+  // projectile: e.g. "BERT" with pi- projectiles builds only the Bertini model,
+  // the pi- cross sections and the pi- inelastic process.
   // Notes:
   // - Neither the hadronic models nor the cross sections are used directly
   //   by the method GenerateInteraction, but they are associated to the
@@ -176,471 +205,482 @@ HadronicGenerator::HadronicGenerator( const G4String physicsCase ) :
   // - Although the class generates only final states, but not free mean paths,
   //   inelastic hadron-nuclear cross sections are needed by Geant4 to sample
   //   the target nucleus from the target material.
-  
+  const auto startTime = std::chrono::steady_clock::now();
+
   // Definition of particles
   G4GenericIon* gion = G4GenericIon::Definition();
   gion->SetProcessManager( new G4ProcessManager( gion ) );
   G4DecayPhysics* decays = new G4DecayPhysics;
-  decays->ConstructParticle();  
+  decays->ConstructParticle();
   fPartTable = G4ParticleTable::GetParticleTable();
   fPartTable->SetReadiness();
   G4IonTable* ions = fPartTable->GetIonTable();
   ions->CreateAllIon();
   ions->CreateAllIsomer();
 
-  // Build BERT model
-  G4CascadeInterface* theBERTmodel = new G4CascadeInterface;
-
-  // Build BIC model
-  G4BinaryCascade* theBICmodel = new G4BinaryCascade;
-  G4PreCompoundModel* thePreEquilib = new G4PreCompoundModel( new G4ExcitationHandler );
-  theBICmodel->SetDeExcitation( thePreEquilib );
-
-  // Build BinaryLightIon model
-  G4PreCompoundModel* thePreEquilibBis = new G4PreCompoundModel( new G4ExcitationHandler );
-  G4BinaryLightIonReaction* theIonBICmodel = new G4BinaryLightIonReaction( thePreEquilibBis );
-
-  // Build the INCL model
-  G4INCLXXInterface* theINCLmodel = new G4INCLXXInterface;
-  const G4bool useAblaDeExcitation = false;  // By default INCL uses Preco: set "true" to use
-                                             // ABLA DeExcitation
-  if ( theINCLmodel && useAblaDeExcitation ) {
-    G4AblaInterface* theAblaInterface = new G4AblaInterface;
-    theINCLmodel->SetDeExcitation( theAblaInterface );
+  for ( std::size_t i = 0; i < fModels.size(); ++i ) fModels[i] = nullptr;
+  for ( std::size_t i = 0; i < fCrossSections.size(); ++i ) fCrossSections[i] = nullptr;
+
+  // Table of the projectiles: inelastic process name, cross sections (needed by Geant4
+  // to sample the target nucleus from the target material) and group of projectiles
+  // sharing the same hadronic models (see RegisterModels).
+  // The position in the table is the dense particle index.
+  fProjectiles = {
+    { G4PionMinus::Definition(), "pi-Inelastic", CrossSection::PionMinus, ProjectileGroup::Pion },
+    { G4PionPlus::Definition(), "pi+Inelastic", CrossSection::PionPlus, ProjectileGroup::Pion },
+    { G4KaonMinus::Definition(), "kaon-Inelastic", CrossSection::Kaon, ProjectileGroup::Kaon },
+    { G4KaonPlus::Definition(), "kaon+Inelastic", CrossSection::Kaon, ProjectileGroup::Kaon },
+    { G4KaonZeroLong::Definition(), "kaon0LInelastic", CrossSection::Kaon, ProjectileGroup::Kaon },
+    { G4KaonZeroShort::Definition(), "kaon0SInelastic", CrossSection::Kaon,
+      ProjectileGroup::Kaon },
+    { G4Proton::Definition(), "protonInelastic", CrossSection::Proton, ProjectileGroup::Nucleon },
+    { G4Neutron::Definition(), "neutronInelastic", CrossSection::Neutron,
+      ProjectileGroup::Nucleon },
+    { G4Deuteron::Definition(), "dInelastic", CrossSection::NuclNucl, ProjectileGroup::Ion },
+    { G4Triton::Definition(), "tInelastic", CrossSection::NuclNucl, ProjectileGroup::Ion },
+    { G4He3::Definition(), "he3Inelastic", CrossSection::NuclNucl, ProjectileGroup::Ion },
+    { G4Alpha::Definition(), "alphaInelastic", CrossSection::NuclNucl, ProjectileGroup::Ion },
+    { G4GenericIon::Definition(), "ionInelastic", CrossSection::NuclNucl, ProjectileGroup::Ion },
+    { G4Lambda::Definition(), "lambdaInelastic", CrossSection::Hyperon, ProjectileGroup::Hyperon },
+    { G4SigmaMinus::Definition(), "sigma-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::Hyperon },
+    { G4SigmaPlus::Definition(), "sigma+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::Hyperon },
+    { G4XiMinus::Definition(), "xi-Inelastic", CrossSection::Hyperon, ProjectileGroup::Hyperon },
+    { G4XiZero::Definition(), "xi0Inelastic", CrossSection::Hyperon, ProjectileGroup::Hyperon },
+    { G4OmegaMinus::Definition(), "omega-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::Hyperon },
+    { G4AntiProton::Definition(), "anti_protonInelastic", CrossSection::Antibaryon,
+      ProjectileGroup::AntiBaryon },
+    { G4AntiNeutron::Definition(), "anti_neutronInelastic", CrossSection::Antibaryon,
+      ProjectileGroup::AntiBaryon },
+    { G4AntiDeuteron::Definition(), "anti_deuteronInelastic", CrossSection::Antibaryon,
+      ProjectileGroup::AntiIon },
+    { G4AntiTriton::Definition(), "anti_tritonInelastic", CrossSection::Antibaryon,
+      ProjectileGroup::AntiIon },
+    { G4AntiHe3::Definition(), "anti_He3Inelastic", CrossSection::Antibaryon,
+      ProjectileGroup::AntiIon },
+    { G4AntiAlpha::Definition(), "anti_alphaInelastic", CrossSection::Hyperon,
+      ProjectileGroup::AntiIon },
+    { G4AntiLambda::Definition(), "anti-lambdaInelastic", CrossSection::Hyperon,
+      ProjectileGroup::AntiBaryon },
+    { G4AntiSigmaMinus::Definition(), "anti_sigma-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::AntiBaryon },
+    { G4AntiSigmaPlus::Definition(), "anti_sigma+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::AntiBaryon },
+    { G4AntiXiMinus::Definition(), "anti_xi-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::AntiBaryon },
+    { G4AntiXiZero::Definition(), "anti_xi0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::AntiBaryon },
+    { G4AntiOmegaMinus::Definition(), "anti_omega-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::AntiBaryon },
+    // For the charmed and bottom hadrons the hyperon cross sections are used
+    { G4DMesonPlus::Definition(), "D+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4DMesonMinus::Definition(), "D-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4DMesonZero::Definition(), "D0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiDMesonZero::Definition(), "anti_D0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4DsMesonPlus::Definition(), "Ds+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4DsMesonMinus::Definition(), "Ds-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4BMesonPlus::Definition(), "B+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4BMesonMinus::Definition(), "B-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4BMesonZero::Definition(), "B0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiBMesonZero::Definition(), "anti_B0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4BsMesonZero::Definition(), "Bs0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiBsMesonZero::Definition(), "anti_Bs0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4BcMesonPlus::Definition(), "Bc+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4BcMesonMinus::Definition(), "Bc-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4LambdacPlus::Definition(), "lambda_c+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiLambdacPlus::Definition(), "anti_lambda_c+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4XicPlus::Definition(), "xi_c+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiXicPlus::Definition(), "anti_xi_c+Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4XicZero::Definition(), "xi_c0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiXicZero::Definition(), "anti_xi_c0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4OmegacZero::Definition(), "omega_c0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiOmegacZero::Definition(), "anti_omega_c0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4Lambdab::Definition(), "lambda_bInelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiLambdab::Definition(), "anti_lambda_bInelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4XibZero::Definition(), "xi_b0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiXibZero::Definition(), "anti_xi_b0Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4XibMinus::Definition(), "xi_b-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiXibMinus::Definition(), "anti_xi_b-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4OmegabMinus::Definition(), "omega_b-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour },
+    { G4AntiOmegabMinus::Definition(), "anti_omega_b-Inelastic", CrossSection::Hyperon,
+      ProjectileGroup::HeavyFlavour } };
+  for ( const auto& projectile : fProjectiles ) fParticleIndex.Insert( projectile.fDefinition );
+  fProcesses.assign( fProjectiles.size(), nullptr );
+
+  fPhysicsCaseIsSupported = ( fPhysicsCaseId != PhysicsCase::Unsupported );
+  if ( ! fPhysicsCaseIsSupported ) {
+    G4cerr << "ERROR: Not supported final-state hadronic inelastic physics case !"
+           << fPhysicsCase << G4endl
+           << "\t Re-try by choosing one of the following:" << G4endl
+           << "\t - Hadronic models : BERT, BIC, IonBIC, INCL, FTFP, QGSP" << G4endl
+           << "\t - \"Physics-list proxies\" : FTFP_BERT (default), FTFP_BERT_ATL, \
+                                               QGSP_BERT, QGSP_BIC, FTFP_INCLXX"
+           << G4endl;
   }
-  
-  // Build the FTFP model (FTF/Preco) : 4 instances with different kinetic energy intervals.
-  // (Notice that these kinetic energy intervals are applied per nucleons, so they are fine
-  // for all types of hadron and ion projectile).
-  // Model instance without energy constraint.
-  // (Used for the case of FTFP model, and for light anti-ions in all physics lists.)
-  G4TheoFSGenerator* theFTFPmodel = new G4TheoFSGenerator( "FTFP" );
-  #if G4VERSION_NUMBER>=1100 
-    theFTFPmodel->SetMaxEnergy( G4HadronicParameters::Instance()->GetMaxEnergy() );
-  #else 
-    theFTFPmodel->SetMaxEnergy(1e+08);
-  #endif
-  G4GeneratorPrecompoundInterface* theCascade = new G4GeneratorPrecompoundInterface;
-  theCascade->SetDeExcitation( thePreEquilib );
-  theFTFPmodel->SetTransport( theCascade );
-  G4LundStringFragmentation* theLundFragmentation = new G4LundStringFragmentation;
-  G4ExcitedStringDecay* theStringDecay = new G4ExcitedStringDecay( theLundFragmentation );
-  G4FTFModel* theStringModel = new G4FTFModel;
-  theStringModel->SetFragmentationModel( theStringDecay );
-
-  // If the following line is set, then the square of the impact parameter is sampled
-  // randomly from a flat distribution in the range [ Bmin*Bmin, Bmax*Bmax ]
-  //theStringModel->SetBminBmax( 0.0, 2.0*fermi );  //***LOOKHERE*** CHOOSE IMPACT PARAMETER MIN & MAX
-
-  theFTFPmodel->SetHighEnergyGenerator( theStringModel );
-  // Model instance with constraint to be above a kinetic energy threshold.
-  // (Used for ions in all physics lists, and, in the case of non-QGS-based physics lists,
-  // also for pions, kaons, nucleons and hyperons.)  
-  G4TheoFSGenerator* theFTFPmodel_aboveThreshold = new G4TheoFSGenerator( "FTFP" );
-  #if G4VERSION_NUMBER>=1100
-    theFTFPmodel_aboveThreshold->SetMaxEnergy( G4HadronicParameters::Instance()->GetMaxEnergy() );
-  #else 
-    theFTFPmodel_aboveThreshold->SetMaxEnergy(1e+08);
-  #endif
-  theFTFPmodel_aboveThreshold->SetTransport( theCascade );
-  theFTFPmodel_aboveThreshold->SetHighEnergyGenerator( theStringModel );
-  // Model instance with constraint to be within two kinetic energy thresholds.
-  // (Used in the case of QGS-based physics lists for pions, kaons, nucleons and hyperons.)  
-  G4TheoFSGenerator* theFTFPmodel_constrained = new G4TheoFSGenerator( "FTFP" );
-  #if G4VERSION_NUMBER>=1100
-    theFTFPmodel_constrained->SetMaxEnergy( G4HadronicParameters::Instance()->GetMaxEnergy() );
-  #else 
-    theFTFPmodel_constrained->SetMaxEnergy(1e+08);
-  #endif
-  theFTFPmodel_constrained->SetTransport( theCascade );
-  theFTFPmodel_constrained->SetHighEnergyGenerator( theStringModel );
-  // Model instance to be used down to zero kinetic energy, with eventual constraint
-  // - in the case of QGS-based physics lists - to be below a kinetic energy threshold.
-  // (Used for anti-baryons, anti-hyperons, and charmed and bottom hadrons.)
-  G4TheoFSGenerator* theFTFPmodel_belowThreshold = new G4TheoFSGenerator( "FTFP" );
-  #if G4VERSION_NUMBER>=1100
-    theFTFPmodel_belowThreshold->SetMaxEnergy( G4HadronicParameters::Instance()->GetMaxEnergy() );
-  #else 
-    theFTFPmodel_belowThreshold->SetMaxEnergy(1e+08);
-  #endif
-  theFTFPmodel_belowThreshold->SetTransport( theCascade );
-  theFTFPmodel_belowThreshold->SetHighEnergyGenerator( theStringModel );
 
-  // Build the QGSP model (QGS/Preco)
-  G4TheoFSGenerator* theQGSPmodel = new G4TheoFSGenerator( "QGSP" );
+  // Projectile track & step: they are created only once here, and then reset
+  // in place by GenerateInteraction, to avoid any heap allocation per interaction.
+  // The dynamic particle is owned (and deleted) by the track; the proton is only
+  // a placeholder, the projectile is set at each call.
+  fDynamicParticle = new G4DynamicParticle( G4Proton::Definition(),
+                                            G4ThreeVector( 0.0, 0.0, 1.0 ), 0.0 );
+  fTrack = new G4Track( fDynamicParticle, 0.0, G4ThreeVector( 0.0, 0.0, 0.0 ) );
+  G4TouchableHandle fpTouchable( new G4TouchableHistory );  // Not strictly needed
+  fTrack->SetTouchableHandle( fpTouchable );                // Not strictly needed
+  fStep = new G4Step;  // It creates its own pre- and post-step points
+  fStep->SetTrack( fTrack );
+  fTrack->SetStep( fStep );
+  fStep->GetPreStepPoint()->SetPosition( G4ThreeVector( 0.0, 0.0, 0.0 ) );
+
+  BuildApplicabilityTable();
+  AddInitTime( "particles", startTime );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HadronicGenerator::AddInitTime( const G4String &component,
+                                     const std::chrono::steady_clock::time_point &startTime ) {
+  const std::chrono::duration< G4double > elapsed = std::chrono::steady_clock::now() - startTime;
+  fInitTimes.push_back( std::make_pair( component, elapsed.count() ) );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HadronicGenerator::PrintInitTimes() const {
+  // The time of a process includes the time of the models and cross sections
+  // that have been built for it (and are printed just before it).
+  G4double totalTime = 0.0;
+  G4cout << "=== HadronicGenerator initialization time (" << fPhysicsCase << ") ===" << G4endl;
+  for ( const auto& initTime : fInitTimes ) {
+    G4cout << "\t" << std::setw( 32 ) << std::left << initTime.first
+           << std::right << initTime.second*1000.0 << " ms" << G4endl;
+    if ( initTime.first.find( "Inelastic" ) != std::string::npos  ||
+         initTime.first == "particles" ) totalTime += initTime.second;
+  }
+  G4cout << "\t" << std::setw( 32 ) << std::left << "total"
+         << std::right << totalTime*1000.0 << " ms" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4PreCompoundModel* HadronicGenerator::GetPreCompoundModel() {
+  // Precompound/de-excitation shared by the Binary Cascade and by the string models.
+  if ( fPreEquilib == nullptr ) fPreEquilib = new G4PreCompoundModel( new G4ExcitationHandler );
+  return fPreEquilib;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4GeneratorPrecompoundInterface* HadronicGenerator::GetPrecompoundInterface() {
+  // Nuclear de-excitation of the string models (FTF and QGS).
+  if ( fPrecoInterface == nullptr ) {
+    fPrecoInterface = new G4GeneratorPrecompoundInterface;
+    fPrecoInterface->SetDeExcitation( GetPreCompoundModel() );
+  }
+  return fPrecoInterface;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4FTFModel* HadronicGenerator::GetFTFStringModel() {
+  // The FTF string model, shared by the 4 instances of the FTFP model.
+  if ( fFTFStringModel == nullptr ) {
+    G4LundStringFragmentation* theLundFragmentation = new G4LundStringFragmentation;
+    G4ExcitedStringDecay* theStringDecay = new G4ExcitedStringDecay( theLundFragmentation );
+    fFTFStringModel = new G4FTFModel;
+    fFTFStringModel->SetFragmentationModel( theStringDecay );
+    // If the following line is set, then the square of the impact parameter is sampled
+    // randomly from a flat distribution in the range [ Bmin*Bmin, Bmax*Bmax ]
+    //fFTFStringModel->SetBminBmax( 0.0, 2.0*fermi );  //***LOOKHERE*** CHOOSE IMPACT PARAMETER MIN & MAX
+  }
+  return fFTFStringModel;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4HadronicInteraction* HadronicGenerator::GetModel( const Model model ) {
+  // Build the hadronic model on first use.
+  G4HadronicInteraction*& theModel = fModels[ static_cast< std::size_t >( model ) ];
+  if ( theModel != nullptr ) return theModel;
+  const auto startTime = std::chrono::steady_clock::now();
+  G4String modelName;
+  G4double maxEnergy;
   #if G4VERSION_NUMBER>=1100
-    theQGSPmodel->SetMaxEnergy( G4HadronicParameters::Instance()->GetMaxEnergy() );
-  #else 
-    theQGSPmodel->SetMaxEnergy(1e+08);
+    maxEnergy = G4HadronicParameters::Instance()->GetMaxEnergy();
+  #else
+    maxEnergy = 1e+08;
   #endif
-  theQGSPmodel->SetTransport( theCascade );
-  G4QGSMFragmentation* theQgsmFragmentation = new G4QGSMFragmentation;
-  G4ExcitedStringDecay* theQgsmStringDecay = new G4ExcitedStringDecay( theQgsmFragmentation );
-  G4VPartonStringModel* theQgsmStringModel = new G4QGSModel< G4QGSParticipants >;
-  theQgsmStringModel->SetFragmentationModel( theQgsmStringDecay );
-  theQGSPmodel->SetHighEnergyGenerator( theQgsmStringModel );
-  G4QuasiElasticChannel* theQuasiElastic = new G4QuasiElasticChannel;  // QGSP uses quasi-elastic
-  theQGSPmodel->SetQuasiElasticChannel( theQuasiElastic );
+  switch ( model ) {
+    case Model::BERT : {
+      // Build BERT model
+      modelName = "BERT";
+      theModel = new G4CascadeInterface;
+      break;
+    }
+    case Model::BIC : {
+      // Build BIC model
+      modelName = "BIC";
+      G4BinaryCascade* theBICmodel = new G4BinaryCascade;
+      theBICmodel->SetDeExcitation( GetPreCompoundModel() );
+      theModel = theBICmodel;
+      break;
+    }
+    case Model::IonBIC : {
+      // Build BinaryLightIon model
+      modelName = "IonBIC";
+      G4PreCompoundModel* thePreEquilibBis = new G4PreCompoundModel( new G4ExcitationHandler );
+      theModel = new G4BinaryLightIonReaction( thePreEquilibBis );
+      break;
+    }
+    case Model::INCL : {
+      // Build the INCL model
+      modelName = "INCL";
+      G4INCLXXInterface* theINCLmodel = new G4INCLXXInterface;
+      const G4bool useAblaDeExcitation = false;  // By default INCL uses Preco: set "true" to use
+                                                 // ABLA DeExcitation
+      if ( theINCLmodel && useAblaDeExcitation ) {
+        G4AblaInterface* theAblaInterface = new G4AblaInterface;
+        theINCLmodel->SetDeExcitation( theAblaInterface );
+      }
+      theModel = theINCLmodel;
+      break;
+    }
+    case Model::FTFP :
+    case Model::FTFP_aboveThreshold :
+    case Model::FTFP_constrained :
+    case Model::FTFP_belowThreshold : {
+      // Build the FTFP model (FTF/Preco) : 4 instances with different kinetic energy intervals.
+      // (Notice that these kinetic energy intervals are applied per nucleons, so they are fine
+      // for all types of hadron and ion projectile).
+      // - FTFP : without energy constraint.
+      //   (Used for the case of FTFP model, and for light anti-ions in all physics lists.)
+      // - FTFP_aboveThreshold : with constraint to be above a kinetic energy threshold.
+      //   (Used for ions in all physics lists, and, in the case of non-QGS-based physics lists,
+      //   also for pions, kaons, nucleons and hyperons.)
+      // - FTFP_constrained : with constraint to be within two kinetic energy thresholds.
+      //   (Used in the case of QGS-based physics lists for pions, kaons, nucleons and hyperons.)
+      // - FTFP_belowThreshold : to be used down to zero kinetic energy, with eventual constraint
+      //   - in the case of QGS-based physics lists - to be below a kinetic energy threshold.
+      //   (Used for anti-baryons, anti-hyperons, and charmed and bottom hadrons.)
+      if ( model == Model::FTFP ) modelName = "FTFP";
+      else if ( model == Model::FTFP_aboveThreshold ) modelName = "FTFP_aboveThreshold";
+      else if ( model == Model::FTFP_constrained ) modelName = "FTFP_constrained";
+      else modelName = "FTFP_belowThreshold";
+      G4TheoFSGenerator* theFTFPmodel = new G4TheoFSGenerator( "FTFP" );
+      theFTFPmodel->SetMaxEnergy( maxEnergy );
+      theFTFPmodel->SetTransport( GetPrecompoundInterface() );
+      theFTFPmodel->SetHighEnergyGenerator( GetFTFStringModel() );
+      theModel = theFTFPmodel;
+      break;
+    }
+    case Model::QGSP : {
+      // Build the QGSP model (QGS/Preco)
+      modelName = "QGSP";
+      G4TheoFSGenerator* theQGSPmodel = new G4TheoFSGenerator( "QGSP" );
+      theQGSPmodel->SetMaxEnergy( maxEnergy );
+      theQGSPmodel->SetTransport( GetPrecompoundInterface() );
+      G4QGSMFragmentation* theQgsmFragmentation = new G4QGSMFragmentation;
+      G4ExcitedStringDecay* theQgsmStringDecay = new G4ExcitedStringDecay( theQgsmFragmentation );
+      G4VPartonStringModel* theQgsmStringModel = new G4QGSModel< G4QGSParticipants >;
+      theQgsmStringModel->SetFragmentationModel( theQgsmStringDecay );
+      theQGSPmodel->SetHighEnergyGenerator( theQgsmStringModel );
+      G4QuasiElasticChannel* theQuasiElastic = new G4QuasiElasticChannel;  // QGSP uses quasi-elastic
+      theQGSPmodel->SetQuasiElasticChannel( theQuasiElastic );
+      theModel = theQGSPmodel;
+      break;
+    }
+    default :
+      return nullptr;
+  }
+  SetModelEnergyRange( model, theModel );
+  AddInitTime( "model " + modelName, startTime );
+  return theModel;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void HadronicGenerator::SetModelEnergyRange( const Model model,
+                                             G4HadronicInteraction* theModel ) const {
   // For the case of "physics-list proxies", select the energy range for each hadronic model.
   // Note: the transition energy between hadronic models vary between physics lists,
   //       type of hadrons, and version of Geant4. Here, for simplicity, we use an uniform
   //       energy transition for all types of hadrons and regardless of the Geant4 version;
   //       moreover, for "FTFP_INCLXX" we use a different energy transition range
   //       between FTFP and INCL than in the real physics list.
-  if ( fPhysicsCase == "FTFP_BERT_ATL"  ||
-       fPhysicsCase == "FTFP_BERT"      ||
-       fPhysicsCase == "FTFP_INCLXX"    ||
-       fPhysicsCase == "QGSP_BERT"      ||
-       fPhysicsCase == "QGSP_BIC" ) {
-    G4double ftfpMinE;
-    #if G4VERSION_NUMBER>=1100
-        ftfpMinE = G4HadronicParameters::Instance()->GetMinEnergyTransitionFTF_Cascade();
-    #else 
-        ftfpMinE = 3000;
-    #endif
-    G4double bertMaxE;
-    #if G4VERSION_NUMBER>=1100
-      bertMaxE = G4HadronicParameters::Instance()->GetMaxEnergyTransitionFTF_Cascade();
-    #else 
-      bertMaxE = 6000;
-    #endif
-    const G4double ftfpMinE_ATL =  9.0*CLHEP::GeV;
-    const G4double bertMaxE_ATL = 12.0*CLHEP::GeV;
-    G4double ftfpMaxE;
-    #if G4VERSION_NUMBER>=1100
-        ftfpMaxE = G4HadronicParameters::Instance()->GetMaxEnergyTransitionQGS_FTF();
-    #else 
-        ftfpMaxE = 25000;
-    #endif
-    G4double qgspMinE;
-    #if G4VERSION_NUMBER>=1100
-        qgspMinE = G4HadronicParameters::Instance()->GetMinEnergyTransitionQGS_FTF();
-    #else 
-        qgspMinE = 12000;
-    #endif
-    theFTFPmodel->SetMinEnergy( 0.0 );
-    theFTFPmodel_belowThreshold->SetMinEnergy( 0.0 );
-    if ( fPhysicsCase == "FTFP_BERT_ATL" ) {
-      theBERTmodel->SetMaxEnergy( bertMaxE_ATL );
-      theIonBICmodel->SetMaxEnergy( bertMaxE_ATL );
-      theFTFPmodel_aboveThreshold->SetMinEnergy( ftfpMinE_ATL );
-      theFTFPmodel_constrained->SetMinEnergy( ftfpMinE_ATL );
-    } else {
-      theBERTmodel->SetMaxEnergy( bertMaxE );
-      theIonBICmodel->SetMaxEnergy( bertMaxE );
-      theFTFPmodel_aboveThreshold->SetMinEnergy( ftfpMinE );
-      theFTFPmodel_constrained->SetMinEnergy( ftfpMinE );
-    }
-    if ( fPhysicsCase == "FTFP_INCLXX" ) {
-      theINCLmodel->SetMaxEnergy( bertMaxE );
-    }
-    if ( fPhysicsCase == "QGSP_BERT"  ||
-         fPhysicsCase == "QGSP_BIC" ) {
-      theFTFPmodel_constrained->SetMaxEnergy( ftfpMaxE );
-      theFTFPmodel_belowThreshold->SetMaxEnergy( ftfpMaxE );
-      theQGSPmodel->SetMinEnergy( qgspMinE );
-      theBICmodel->SetMaxEnergy( bertMaxE );
+  if ( ! ( fPhysicsCaseId == PhysicsCase::FTFP_BERT_ATL  ||
+           fPhysicsCaseId == PhysicsCase::FTFP_BERT      ||
+           fPhysicsCaseId == PhysicsCase::FTFP_INCLXX    ||
+           fPhysicsCaseId == PhysicsCase::QGSP_BERT      ||
+           fPhysicsCaseId == PhysicsCase::QGSP_BIC ) ) return;
+  G4double ftfpMinE;
+  #if G4VERSION_NUMBER>=1100
+      ftfpMinE = G4HadronicParameters::Instance()->GetMinEnergyTransitionFTF_Cascade();
+  #else
+      ftfpMinE = 3000;
+  #endif
+  G4double bertMaxE;
+  #if G4VERSION_NUMBER>=1100
+    bertMaxE = G4HadronicParameters::Instance()->GetMaxEnergyTransitionFTF_Cascade();
+  #else
+    bertMaxE = 6000;
+  #endif
+  const G4double ftfpMinE_ATL =  9.0*CLHEP::GeV;
+  const G4double bertMaxE_ATL = 12.0*CLHEP::GeV;
+  G4double ftfpMaxE;
+  #if G4VERSION_NUMBER>=1100
+      ftfpMaxE = G4HadronicParameters::Instance()->GetMaxEnergyTransitionQGS_FTF();
+  #else
+      ftfpMaxE = 25000;
+  #endif
+  G4double qgspMinE;
+  #if G4VERSION_NUMBER>=1100
+      qgspMinE = G4HadronicParameters::Instance()->GetMinEnergyTransitionQGS_FTF();
+  #else
+      qgspMinE = 12000;
+  #endif
+  const G4bool isATL = ( fPhysicsCaseId == PhysicsCase::FTFP_BERT_ATL );
+  const G4bool isQGS = ( fPhysicsCaseId == PhysicsCase::QGSP_BERT  ||
+                         fPhysicsCaseId == PhysicsCase::QGSP_BIC );
+  switch ( model ) {
+    case Model::BERT :
+    case Model::IonBIC :
+      theModel->SetMaxEnergy( isATL ? bertMaxE_ATL : bertMaxE );
+      break;
+    case Model::INCL :
+      if ( fPhysicsCaseId == PhysicsCase::FTFP_INCLXX ) theModel->SetMaxEnergy( bertMaxE );
+      break;
+    case Model::BIC :
+      if ( isQGS ) theModel->SetMaxEnergy( bertMaxE );
+      break;
+    case Model::FTFP :
+      theModel->SetMinEnergy( 0.0 );
+      break;
+    case Model::FTFP_aboveThreshold :
+      theModel->SetMinEnergy( isATL ? ftfpMinE_ATL : ftfpMinE );
+      break;
+    case Model::FTFP_constrained :
+      theModel->SetMinEnergy( isATL ? ftfpMinE_ATL : ftfpMinE );
+      if ( isQGS ) theModel->SetMaxEnergy( ftfpMaxE );
+      break;
+    case Model::FTFP_belowThreshold :
+      theModel->SetMinEnergy( 0.0 );
+      if ( isQGS ) theModel->SetMaxEnergy( ftfpMaxE );
+      break;
+    case Model::QGSP :
+      if ( isQGS ) theModel->SetMinEnergy( qgspMinE );
+      break;
+    default :
+      break;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VCrossSectionDataSet* HadronicGenerator::GetCrossSection( const CrossSection crossSection,
+                                                            G4ParticleDefinition* projectile ) {
+  // Build the cross sections on first use. The datasets that need it have their
+  // physics table built once per projectile, or, if a cache directory is set,
+  // loaded from the cache (see CachedCrossSection).
+  G4VCrossSectionDataSet*& theXSdata = fCrossSections[ static_cast< std::size_t >( crossSection ) ];
+  const auto startTime = std::chrono::steady_clock::now();
+  const G4bool isNew = ( theXSdata == nullptr );
+  G4bool buildPhysicsTable = true;
+  if ( isNew ) {
+    switch ( crossSection ) {
+      case CrossSection::PionMinus :
+        theXSdata = new G4BGGPionInelasticXS( G4PionMinus::Definition() );
+        break;
+      case CrossSection::PionPlus :
+        theXSdata = new G4BGGPionInelasticXS( G4PionPlus::Definition() );
+        break;
+      case CrossSection::Kaon :
+        theXSdata = new G4CrossSectionInelastic( new G4ComponentGGHadronNucleusXsc );
+        break;
+      case CrossSection::Proton :
+        theXSdata = new G4BGGNucleonInelasticXS( G4Proton::Proton() );
+        break;
+      case CrossSection::Neutron :
+        theXSdata = new G4NeutronInelasticXS;
+        break;
+      case CrossSection::Hyperon :
+        // For hyperon and anti-hyperons we can use either Chips or, for G4 >= 10.5,
+        // Glauber-Gribov cross sections
+        //theXSdata = new G4ChipsHyperonInelasticXS;
+        theXSdata = new G4CrossSectionInelastic( new G4ComponentGGHadronNucleusXsc );
+        buildPhysicsTable = false;
+        break;
+      case CrossSection::Antibaryon :
+        theXSdata = new G4CrossSectionInelastic( new G4ComponentAntiNuclNuclearXS );
+        buildPhysicsTable = false;
+        break;
+      case CrossSection::NuclNucl :
+        theXSdata = new G4CrossSectionInelastic( new G4ComponentGGNuclNuclXsc );
+        buildPhysicsTable = false;
+        break;
+      default :
+        return nullptr;
     }
+  } else {
+    // Already built: only the kaon cross sections are shared between projectiles
+    // that need their physics table.
+    buildPhysicsTable = ( crossSection == CrossSection::Kaon );
   }
+  if ( buildPhysicsTable  &&  ! fCrossSectionCacheDir.empty() ) {
+    // The cross sections at the energies of the run are taken from (or written to)
+    // the cache: the physics table of the dataset is built only if the cache does
+    // not match, or at the first call the cache does not cover.
+    CachedCrossSection* theCachedXSdata =
+      new CachedCrossSection( theXSdata, fCrossSectionCacheDir, fPhysicsCase,
+                              fCrossSectionCacheEnergies );
+    theCachedXSdata->BuildPhysicsTable( *projectile );
+    AddInitTime( "cross sections " + projectile->GetParticleName() +
+                 ( theCachedXSdata->IsLoadedFromCache() ? " (cache)" : " (rebuilt)" ),
+                 startTime );
+    return theCachedXSdata;
+  }
+  if ( buildPhysicsTable ) theXSdata->BuildPhysicsTable( *projectile );
+  if ( isNew  ||  buildPhysicsTable ) {
+    AddInitTime( "cross sections " + projectile->GetParticleName(), startTime );
+  }
+  return theXSdata;
+}
 
-  // Cross sections (needed by Geant4 to sample the target nucleus from the target material)
-  G4VCrossSectionDataSet* thePionMinusXSdata =
-    new G4BGGPionInelasticXS( G4PionMinus::Definition() );
-  thePionMinusXSdata->BuildPhysicsTable( *(G4PionMinus::Definition()) );
-  G4VCrossSectionDataSet* thePionPlusXSdata =
-    new G4BGGPionInelasticXS( G4PionPlus::Definition() );
-  thePionPlusXSdata->BuildPhysicsTable( *(G4PionPlus::Definition()) );
-  G4VCrossSectionDataSet* theKaonXSdata =
-    new G4CrossSectionInelastic( new G4ComponentGGHadronNucleusXsc );
-  theKaonXSdata->BuildPhysicsTable( *(G4KaonMinus::Definition()) );
-  theKaonXSdata->BuildPhysicsTable( *(G4KaonPlus::Definition()) );
-  theKaonXSdata->BuildPhysicsTable( *(G4KaonZeroLong::Definition()) );
-  theKaonXSdata->BuildPhysicsTable( *(G4KaonZeroShort::Definition()) );
-  G4VCrossSectionDataSet* theProtonXSdata = new G4BGGNucleonInelasticXS( G4Proton::Proton() );
-  theProtonXSdata->BuildPhysicsTable( *(G4Proton::Definition()) );
-  G4VCrossSectionDataSet* theNeutronXSdata = new G4NeutronInelasticXS;
-  theNeutronXSdata->BuildPhysicsTable( *(G4Neutron::Definition()) );
-  // For hyperon and anti-hyperons we can use either Chips or, for G4 >= 10.5,
-  // Glauber-Gribov cross sections
-  //G4VCrossSectionDataSet* theHyperonsXSdata = new G4ChipsHyperonInelasticXS;
-  G4VCrossSectionDataSet* theHyperonsXSdata =
-    new G4CrossSectionInelastic( new G4ComponentGGHadronNucleusXsc );
-  G4VCrossSectionDataSet* theAntibaryonsXSdata =
-    new G4CrossSectionInelastic( new G4ComponentAntiNuclNuclearXS );
-  G4VCrossSectionDataSet* theNuclNuclXSdata =
-    new G4CrossSectionInelastic( new G4ComponentGGNuclNuclXsc );
-
-  // Set up inelastic processes : store them in a map (with particle definition as key)
-  //                              for convenience
-  typedef std::pair< G4ParticleDefinition*, G4HadronicProcess* > ProcessPair;
-  G4HadronicProcess* thePionMinusInelasticProcess =
-    new G4HadronInelasticProcess( "pi-Inelastic", G4PionMinus::Definition() );    
-  fProcessMap.insert( ProcessPair( G4PionMinus::Definition(), thePionMinusInelasticProcess ) );
-  G4HadronicProcess* thePionPlusInelasticProcess =
-    new G4HadronInelasticProcess( "pi+Inelastic", G4PionPlus::Definition() );    
-  fProcessMap.insert( ProcessPair( G4PionPlus::Definition(), thePionPlusInelasticProcess ) );
-  G4HadronicProcess* theKaonMinusInelasticProcess =
-    new G4HadronInelasticProcess( "kaon-Inelastic", G4KaonMinus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4KaonMinus::Definition(), theKaonMinusInelasticProcess ) );
-  G4HadronicProcess* theKaonPlusInelasticProcess =
-    new G4HadronInelasticProcess( "kaon+Inelastic", G4KaonPlus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4KaonPlus::Definition(), theKaonPlusInelasticProcess ) );
-  G4HadronicProcess* theKaonZeroLInelasticProcess =
-    new G4HadronInelasticProcess( "kaon0LInelastic", G4KaonZeroLong::Definition() );        
-  fProcessMap.insert( ProcessPair( G4KaonZeroLong::Definition(), theKaonZeroLInelasticProcess ) );
-  G4HadronicProcess* theKaonZeroSInelasticProcess =
-    new G4HadronInelasticProcess( "kaon0SInelastic", G4KaonZeroShort::Definition() );        
-  fProcessMap.insert( ProcessPair( G4KaonZeroShort::Definition(), theKaonZeroSInelasticProcess ) );
-  G4HadronicProcess* theProtonInelasticProcess =
-    new G4HadronInelasticProcess( "protonInelastic", G4Proton::Definition() );        
-  fProcessMap.insert( ProcessPair( G4Proton::Definition(), theProtonInelasticProcess ) );
-  G4HadronicProcess* theNeutronInelasticProcess =
-    new G4HadronInelasticProcess( "neutronInelastic", G4Neutron::Definition() );        
-  fProcessMap.insert( ProcessPair( G4Neutron::Definition(), theNeutronInelasticProcess ) );
-  G4HadronicProcess* theDeuteronInelasticProcess =
-    new G4HadronInelasticProcess( "dInelastic", G4Deuteron::Definition() );        
-  fProcessMap.insert( ProcessPair( G4Deuteron::Definition(), theDeuteronInelasticProcess ) );
-  G4HadronicProcess* theTritonInelasticProcess =
-    new G4HadronInelasticProcess( "tInelastic", G4Triton::Definition() );        
-  fProcessMap.insert( ProcessPair( G4Triton::Definition(), theTritonInelasticProcess ) );
-  G4HadronicProcess* theHe3InelasticProcess =
-    new G4HadronInelasticProcess( "he3Inelastic", G4He3::Definition() );        
-  fProcessMap.insert( ProcessPair( G4He3::Definition(), theHe3InelasticProcess ) );
-  G4HadronicProcess* theAlphaInelasticProcess =
-    new G4HadronInelasticProcess( "alphaInelastic", G4Alpha::Definition() );        
-  fProcessMap.insert( ProcessPair( G4Alpha::Definition(), theAlphaInelasticProcess ) );
-  G4HadronicProcess* theIonInelasticProcess =
-    new G4HadronInelasticProcess( "ionInelastic", G4GenericIon::Definition() );        
-  fProcessMap.insert( ProcessPair( G4GenericIon::Definition(), theIonInelasticProcess ) );
-  G4HadronicProcess* theLambdaInelasticProcess =
-    new G4HadronInelasticProcess( "lambdaInelastic", G4Lambda::Definition() );        
-  fProcessMap.insert( ProcessPair( G4Lambda::Definition(), theLambdaInelasticProcess ) );
-  G4HadronicProcess* theSigmaMinusInelasticProcess =
-    new G4HadronInelasticProcess( "sigma-Inelastic", G4SigmaMinus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4SigmaMinus::Definition(), theSigmaMinusInelasticProcess ) );
-  G4HadronicProcess* theSigmaPlusInelasticProcess =
-    new G4HadronInelasticProcess( "sigma+Inelastic", G4SigmaPlus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4SigmaPlus::Definition(), theSigmaPlusInelasticProcess ) );
-  G4HadronicProcess* theXiMinusInelasticProcess =
-    new G4HadronInelasticProcess( "xi-Inelastic", G4XiMinus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4XiMinus::Definition(), theXiMinusInelasticProcess ) );
-  G4HadronicProcess* theXiZeroInelasticProcess =
-    new G4HadronInelasticProcess( "xi0Inelastic", G4XiZero::Definition() );        
-  fProcessMap.insert( ProcessPair( G4XiZero::Definition(), theXiZeroInelasticProcess ) );
-  G4HadronicProcess* theOmegaMinusInelasticProcess =
-    new G4HadronInelasticProcess( "omega-Inelastic", G4OmegaMinus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4OmegaMinus::Definition(), theOmegaMinusInelasticProcess ) );
-  G4HadronicProcess* theAntiProtonInelasticProcess =
-    new G4HadronInelasticProcess( "anti_protonInelastic", G4AntiProton::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiProton::Definition(), theAntiProtonInelasticProcess ) );
-  G4HadronicProcess* theAntiNeutronInelasticProcess =
-    new G4HadronInelasticProcess( "anti_neutronInelastic", G4AntiNeutron::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiNeutron::Definition(), theAntiNeutronInelasticProcess ) );
-  G4HadronicProcess* theAntiDeuteronInelasticProcess =
-    new G4HadronInelasticProcess( "anti_deuteronInelastic", G4AntiDeuteron::Definition() );            
-  fProcessMap.insert( ProcessPair( G4AntiDeuteron::Definition(),
-                                   theAntiDeuteronInelasticProcess ) );
-  G4HadronicProcess* theAntiTritonInelasticProcess =
-    new G4HadronInelasticProcess( "anti_tritonInelastic", G4AntiTriton::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiTriton::Definition(), theAntiTritonInelasticProcess ) );
-  G4HadronicProcess* theAntiHe3InelasticProcess =
-    new G4HadronInelasticProcess( "anti_He3Inelastic", G4AntiHe3::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiHe3::Definition(), theAntiHe3InelasticProcess ) );
-  G4HadronicProcess* theAntiAlphaInelasticProcess =
-    new G4HadronInelasticProcess( "anti_alphaInelastic", G4AntiAlpha::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiAlpha::Definition(), theAntiAlphaInelasticProcess ) );
-  G4HadronicProcess* theAntiLambdaInelasticProcess =
-    new G4HadronInelasticProcess( "anti-lambdaInelastic", G4AntiLambda::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiLambda::Definition(), theAntiLambdaInelasticProcess ) );
-  G4HadronicProcess* theAntiSigmaMinusInelasticProcess =
-    new G4HadronInelasticProcess( "anti_sigma-Inelastic", G4AntiSigmaMinus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiSigmaMinus::Definition(),
-                                   theAntiSigmaMinusInelasticProcess ) );
-  G4HadronicProcess* theAntiSigmaPlusInelasticProcess =
-    new G4HadronInelasticProcess( "anti_sigma+Inelastic", G4AntiSigmaPlus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiSigmaPlus::Definition(),
-                                   theAntiSigmaPlusInelasticProcess ) );
-  G4HadronicProcess* theAntiXiMinusInelasticProcess =
-    new G4HadronInelasticProcess( "anti_xi-Inelastic", G4AntiXiMinus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiXiMinus::Definition(), theAntiXiMinusInelasticProcess ) );
-  G4HadronicProcess* theAntiXiZeroInelasticProcess =
-    new G4HadronInelasticProcess( "anti_xi0Inelastic", G4AntiXiZero::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiXiZero::Definition(), theAntiXiZeroInelasticProcess ) );
-  G4HadronicProcess* theAntiOmegaMinusInelasticProcess =
-    new G4HadronInelasticProcess( "anti_omega-Inelastic", G4AntiOmegaMinus::Definition() );        
-  fProcessMap.insert( ProcessPair( G4AntiOmegaMinus::Definition(),
-                                   theAntiOmegaMinusInelasticProcess ) );
-
-  G4HadronicProcess* theDPlusInelasticProcess =
-    new G4HadronInelasticProcess( "D+Inelastic", G4DMesonPlus::Definition() );
-  fProcessMap.insert( ProcessPair( G4DMesonPlus::Definition(), theDPlusInelasticProcess ) );
-  G4HadronicProcess* theDMinusInelasticProcess =
-    new G4HadronInelasticProcess( "D-Inelastic", G4DMesonMinus::Definition() );
-  fProcessMap.insert( ProcessPair( G4DMesonMinus::Definition(), theDMinusInelasticProcess ) );
-  G4HadronicProcess* theDZeroInelasticProcess =
-    new G4HadronInelasticProcess( "D0Inelastic", G4DMesonZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4DMesonZero::Definition(), theDZeroInelasticProcess ) );
-  G4HadronicProcess* theAntiDZeroInelasticProcess =
-    new G4HadronInelasticProcess( "anti_D0Inelastic", G4AntiDMesonZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiDMesonZero::Definition(),
-				   theAntiDZeroInelasticProcess ) );
-  G4HadronicProcess* theDsPlusInelasticProcess =
-    new G4HadronInelasticProcess( "Ds+Inelastic", G4DsMesonPlus::Definition() );
-  fProcessMap.insert( ProcessPair( G4DsMesonPlus::Definition(), theDsPlusInelasticProcess ) );
-  G4HadronicProcess* theDsMinusInelasticProcess =
-    new G4HadronInelasticProcess( "Ds-Inelastic", G4DsMesonMinus::Definition() );
-  fProcessMap.insert( ProcessPair( G4DsMesonMinus::Definition(), theDsMinusInelasticProcess ) );
-  G4HadronicProcess* theBPlusInelasticProcess =
-    new G4HadronInelasticProcess( "B+Inelastic", G4BMesonPlus::Definition() );
-  fProcessMap.insert( ProcessPair( G4BMesonPlus::Definition(), theBPlusInelasticProcess ) );
-  G4HadronicProcess* theBMinusInelasticProcess =
-    new G4HadronInelasticProcess( "B-Inelastic", G4BMesonMinus::Definition() );
-  fProcessMap.insert( ProcessPair( G4BMesonMinus::Definition(), theBMinusInelasticProcess ) );
-  G4HadronicProcess* theBZeroInelasticProcess =
-    new G4HadronInelasticProcess( "B0Inelastic", G4BMesonZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4BMesonZero::Definition(), theBZeroInelasticProcess ) );
-  G4HadronicProcess* theAntiBZeroInelasticProcess =
-    new G4HadronInelasticProcess( "anti_B0Inelastic", G4AntiBMesonZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiBMesonZero::Definition(),
-				   theAntiBZeroInelasticProcess ) );
-  G4HadronicProcess* theBsZeroInelasticProcess =
-    new G4HadronInelasticProcess( "Bs0Inelastic", G4BsMesonZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4BsMesonZero::Definition(), theBsZeroInelasticProcess ) );
-  G4HadronicProcess* theAntiBsZeroInelasticProcess =
-    new G4HadronInelasticProcess( "anti_Bs0Inelastic", G4AntiBsMesonZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiBsMesonZero::Definition(),
-				   theAntiBsZeroInelasticProcess ) );
-  G4HadronicProcess* theBcPlusInelasticProcess =
-    new G4HadronInelasticProcess( "Bc+Inelastic", G4BcMesonPlus::Definition() );
-  fProcessMap.insert( ProcessPair( G4BcMesonPlus::Definition(), theBcPlusInelasticProcess ) );
-  G4HadronicProcess* theBcMinusInelasticProcess =
-    new G4HadronInelasticProcess( "Bc-Inelastic", G4BcMesonMinus::Definition() );
-  fProcessMap.insert( ProcessPair( G4BcMesonMinus::Definition(), theBcMinusInelasticProcess ) );
-  G4HadronicProcess* theLambdacPlusInelasticProcess =
-    new G4HadronInelasticProcess( "lambda_c+Inelastic", G4LambdacPlus::Definition() );
-  fProcessMap.insert( ProcessPair( G4LambdacPlus::Definition(),
-				   theLambdacPlusInelasticProcess ) );
-  G4HadronicProcess* theAntiLambdacPlusInelasticProcess =
-    new G4HadronInelasticProcess( "anti_lambda_c+Inelastic", G4AntiLambdacPlus::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiLambdacPlus::Definition(),
-				   theAntiLambdacPlusInelasticProcess ) );
-  G4HadronicProcess* theXicPlusInelasticProcess =
-    new G4HadronInelasticProcess( "xi_c+Inelastic", G4XicPlus::Definition() );
-  fProcessMap.insert( ProcessPair( G4XicPlus::Definition(), theXicPlusInelasticProcess ) );
-  G4HadronicProcess* theAntiXicPlusInelasticProcess =
-    new G4HadronInelasticProcess( "anti_xi_c+Inelastic", G4AntiXicPlus::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiXicPlus::Definition(),
-				   theAntiXicPlusInelasticProcess ) );
-  G4HadronicProcess* theXicZeroInelasticProcess =
-    new G4HadronInelasticProcess( "xi_c0Inelastic", G4XicZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4XicZero::Definition(), theXicZeroInelasticProcess ) );
-  G4HadronicProcess* theAntiXicZeroInelasticProcess =
-    new G4HadronInelasticProcess( "anti_xi_c0Inelastic", G4AntiXicZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiXicZero::Definition(),
-				   theAntiXicZeroInelasticProcess ) );
-  G4HadronicProcess* theOmegacZeroInelasticProcess =
-    new G4HadronInelasticProcess( "omega_c0Inelastic", G4OmegacZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4OmegacZero::Definition(), theOmegacZeroInelasticProcess ) );
-  G4HadronicProcess* theAntiOmegacZeroInelasticProcess =
-    new G4HadronInelasticProcess( "anti_omega_c0Inelastic", G4AntiOmegacZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiOmegacZero::Definition(),
-				   theAntiOmegacZeroInelasticProcess ) );
-  G4HadronicProcess* theLambdabInelasticProcess =
-    new G4HadronInelasticProcess( "lambda_bInelastic", G4Lambdab::Definition() );
-  fProcessMap.insert( ProcessPair( G4Lambdab::Definition(), theLambdabInelasticProcess ) );
-  G4HadronicProcess* theAntiLambdabInelasticProcess =
-    new G4HadronInelasticProcess( "anti_lambda_bInelastic", G4AntiLambdab::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiLambdab::Definition(),
-				   theAntiLambdabInelasticProcess ) );
-  G4HadronicProcess* theXibZeroInelasticProcess =
-    new G4HadronInelasticProcess( "xi_b0Inelastic", G4XibZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4XibZero::Definition(), theXibZeroInelasticProcess ) );
-  G4HadronicProcess* theAntiXibZeroInelasticProcess =
-    new G4HadronInelasticProcess( "anti_xi_b0Inelastic", G4AntiXibZero::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiXibZero::Definition(),
-				   theAntiXibZeroInelasticProcess ) );
-  G4HadronicProcess* theXibMinusInelasticProcess =
-    new G4HadronInelasticProcess( "xi_b-Inelastic", G4XibMinus::Definition() );
-  fProcessMap.insert( ProcessPair( G4XibMinus::Definition(), theXibMinusInelasticProcess ) );
-  G4HadronicProcess* theAntiXibMinusInelasticProcess =
-    new G4HadronInelasticProcess( "anti_xi_b-Inelastic", G4AntiXibMinus::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiXibMinus::Definition(),
-				   theAntiXibMinusInelasticProcess ) );
-  G4HadronicProcess* theOmegabMinusInelasticProcess =
-    new G4HadronInelasticProcess( "omega_b-Inelastic", G4OmegabMinus::Definition() );
-  fProcessMap.insert( ProcessPair( G4OmegabMinus::Definition(),
-				   theOmegabMinusInelasticProcess ) );
-  G4HadronicProcess* theAntiOmegabMinusInelasticProcess =
-    new G4HadronInelasticProcess( "anti_omega_b-Inelastic", G4AntiOmegabMinus::Definition() );
-  fProcessMap.insert( ProcessPair( G4AntiOmegabMinus::Definition(),
-				   theAntiOmegabMinusInelasticProcess ) );
-
-  // Add the cross sections to the corresponding hadronic processes
-  thePionMinusInelasticProcess->AddDataSet( thePionMinusXSdata );
-  thePionPlusInelasticProcess->AddDataSet( thePionPlusXSdata );
-  theKaonMinusInelasticProcess->AddDataSet( theKaonXSdata );
-  theKaonPlusInelasticProcess->AddDataSet( theKaonXSdata );
-  theKaonZeroLInelasticProcess->AddDataSet( theKaonXSdata );
-  theKaonZeroSInelasticProcess->AddDataSet( theKaonXSdata );
-  theProtonInelasticProcess->AddDataSet( theProtonXSdata );
-  theNeutronInelasticProcess->AddDataSet( theNeutronXSdata );
-  theDeuteronInelasticProcess->AddDataSet( theNuclNuclXSdata );
-  theTritonInelasticProcess->AddDataSet( theNuclNuclXSdata );
-  theHe3InelasticProcess->AddDataSet( theNuclNuclXSdata );
-  theAlphaInelasticProcess->AddDataSet( theNuclNuclXSdata );
-  theIonInelasticProcess->AddDataSet( theNuclNuclXSdata );
-  theLambdaInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theSigmaMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theSigmaPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theXiMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theXiZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theOmegaMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiProtonInelasticProcess->AddDataSet( theAntibaryonsXSdata );
-  theAntiNeutronInelasticProcess->AddDataSet( theAntibaryonsXSdata );
-  theAntiDeuteronInelasticProcess->AddDataSet( theAntibaryonsXSdata );
-  theAntiTritonInelasticProcess->AddDataSet( theAntibaryonsXSdata );
-  theAntiHe3InelasticProcess->AddDataSet( theAntibaryonsXSdata );
-  theAntiAlphaInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiLambdaInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiSigmaMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiSigmaPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiXiMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiXiZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiOmegaMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-
-  theDPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theDMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theDZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiDZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theDsPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theDsMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theBPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theBMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theBZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiBZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theBsZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiBsZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theBcPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theBcMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theLambdacPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiLambdacPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theXicPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiXicPlusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theXicZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiXicZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theOmegacZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiOmegacZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theLambdabInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiLambdabInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theXibZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiXibZeroInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theXibMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiXibMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theOmegabMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-  theAntiOmegabMinusInelasticProcess->AddDataSet( theHyperonsXSdata );
-
-  // Register the proper hadronic model(s) to the corresponding hadronic processes.
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HadronicGenerator::RegisterModels( G4HadronicProcess* theProcess,
+                                        const ProjectileGroup group ) {
+  // Register the proper hadronic model(s) to the hadronic process.
   // Note: hadronic models ("BERT", "BIC", "IonBIC", "INCL", "FTFP", "QGSP") are
   //       used for the hadrons and energies they are applicable
   //       (exception for INCL, which in recent versions of Geant4 can handle
@@ -649,300 +689,209 @@ HadronicGenerator::HadronicGenerator( const G4String physicsCase ) :
   //       "QGSP_BIC", "FTFP_INCLXX"), all hadron types and all energies are covered
   //       by combining different hadronic models - similarly (but not identically)
   //       to the corresponding physics lists.
-  if ( fPhysicsCase == "BIC"  ||
-       fPhysicsCase == "QGSP_BIC" ) {
+  const PhysicsCase pc = fPhysicsCaseId;
+  const G4bool isPionOrNucleon = ( group == ProjectileGroup::Pion  ||
+                                   group == ProjectileGroup::Nucleon );
+  const G4bool isKaonOrHyperon = ( group == ProjectileGroup::Kaon  ||
+                                   group == ProjectileGroup::Hyperon );
+  if ( isPionOrNucleon  &&  ( pc == PhysicsCase::BIC  ||  pc == PhysicsCase::QGSP_BIC ) ) {
     // The BIC model is applicable to nucleons and pions,
     // whereas in the physics list QGSP_BIC it is used only for nucleons
-    fPhysicsCaseIsSupported = true;
-    theProtonInelasticProcess->RegisterMe( theBICmodel );
-    theNeutronInelasticProcess->RegisterMe( theBICmodel );
-    if ( fPhysicsCase == "BIC" ) {
-      thePionMinusInelasticProcess->RegisterMe( theBICmodel );
-      thePionPlusInelasticProcess->RegisterMe( theBICmodel );
+    if ( group == ProjectileGroup::Pion  &&  pc == PhysicsCase::QGSP_BIC ) {
+      theProcess->RegisterMe( GetModel( Model::BERT ) );
     } else {
-      thePionMinusInelasticProcess->RegisterMe( theBERTmodel );
-      thePionPlusInelasticProcess->RegisterMe( theBERTmodel );
+      theProcess->RegisterMe( GetModel( Model::BIC ) );
     }
-  } else if ( fPhysicsCase == "INCL"  ||
-              fPhysicsCase == "FTFP_INCLXX" ) {
+  } else if ( isPionOrNucleon  &&
+              ( pc == PhysicsCase::INCL  ||  pc == PhysicsCase::FTFP_INCLXX ) ) {
     // We consider here for simplicity only nucleons and pions
     // (although recent versions of INCL can handle others particles as well)
-    fPhysicsCaseIsSupported = true;
-    thePionMinusInelasticProcess->RegisterMe( theINCLmodel );    
-    thePionPlusInelasticProcess->RegisterMe( theINCLmodel );    
-    theProtonInelasticProcess->RegisterMe( theINCLmodel );    
-    theNeutronInelasticProcess->RegisterMe( theINCLmodel );    
+    theProcess->RegisterMe( GetModel( Model::INCL ) );
   }
-  if ( fPhysicsCase == "IonBIC"         ||
-       fPhysicsCase == "FTFP_BERT_ATL"  ||
-       fPhysicsCase == "FTFP_BERT"      ||
-       fPhysicsCase == "FTFP_INCLXX"    ||
-       fPhysicsCase == "QGSP_BERT"      ||
-       fPhysicsCase == "QGSP_BIC"  ) {
+  if ( group == ProjectileGroup::Ion  &&
+       ( pc == PhysicsCase::IonBIC         ||
+         pc == PhysicsCase::FTFP_BERT_ATL  ||
+         pc == PhysicsCase::FTFP_BERT      ||
+         pc == PhysicsCase::FTFP_INCLXX    ||
+         pc == PhysicsCase::QGSP_BERT      ||
+         pc == PhysicsCase::QGSP_BIC ) ) {
     // The Binary Light Ion model is used for ions in all physics lists
-    fPhysicsCaseIsSupported = true;
-    theDeuteronInelasticProcess->RegisterMe( theIonBICmodel );    
-    theTritonInelasticProcess->RegisterMe( theIonBICmodel );    
-    theHe3InelasticProcess->RegisterMe( theIonBICmodel );    
-    theAlphaInelasticProcess->RegisterMe( theIonBICmodel );  
-    theIonInelasticProcess->RegisterMe( theIonBICmodel );
+    theProcess->RegisterMe( GetModel( Model::IonBIC ) );
   }
-  if ( fPhysicsCase == "QGSP"       ||
-       fPhysicsCase == "QGSP_BERT"  ||
-       fPhysicsCase == "QGSP_BIC" ) {
-    fPhysicsCaseIsSupported = true;
-    thePionMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    thePionPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theKaonMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theKaonPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theKaonZeroLInelasticProcess->RegisterMe( theQGSPmodel );
-    theKaonZeroSInelasticProcess->RegisterMe( theQGSPmodel );
-    theProtonInelasticProcess->RegisterMe( theQGSPmodel );
-    theNeutronInelasticProcess->RegisterMe( theQGSPmodel );
-    theLambdaInelasticProcess->RegisterMe( theQGSPmodel );
-    theSigmaMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theSigmaPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theXiMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theXiZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theOmegaMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiProtonInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiNeutronInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiLambdaInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiSigmaMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiSigmaPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiXiMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiXiZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiOmegaMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theDPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theDMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theDZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiDZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theDsPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theDsMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theBPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theBMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theBZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiBZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theBsZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiBsZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theBcPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theBcMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theLambdacPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiLambdacPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theXicPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiXicPlusInelasticProcess->RegisterMe( theQGSPmodel );
-    theXicZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiXicZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theOmegacZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiOmegacZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theLambdabInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiLambdabInelasticProcess->RegisterMe( theQGSPmodel );
-    theXibZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiXibZeroInelasticProcess->RegisterMe( theQGSPmodel );
-    theXibMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiXibMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theOmegabMinusInelasticProcess->RegisterMe( theQGSPmodel );
-    theAntiOmegabMinusInelasticProcess->RegisterMe( theQGSPmodel );
+  if ( group != ProjectileGroup::Ion  &&  group != ProjectileGroup::AntiIon  &&
+       ( pc == PhysicsCase::QGSP       ||
+         pc == PhysicsCase::QGSP_BERT  ||
+         pc == PhysicsCase::QGSP_BIC ) ) {
+    theProcess->RegisterMe( GetModel( Model::QGSP ) );
   }
-  if ( fPhysicsCase == "BERT"           ||
-       fPhysicsCase == "FTFP_BERT_ATL"  ||
-       fPhysicsCase == "FTFP_BERT"      ||
-       fPhysicsCase == "QGSP_BERT" ) {
+  if ( isPionOrNucleon  &&
+       ( pc == PhysicsCase::BERT           ||
+         pc == PhysicsCase::FTFP_BERT_ATL  ||
+         pc == PhysicsCase::FTFP_BERT      ||
+         pc == PhysicsCase::QGSP_BERT ) ) {
     // The BERT model is used for pions and nucleons in all Bertini-based physics lists
-    fPhysicsCaseIsSupported = true;
-    thePionMinusInelasticProcess->RegisterMe( theBERTmodel );
-    thePionPlusInelasticProcess->RegisterMe( theBERTmodel );
-    theProtonInelasticProcess->RegisterMe( theBERTmodel );
-    theNeutronInelasticProcess->RegisterMe( theBERTmodel );
+    theProcess->RegisterMe( GetModel( Model::BERT ) );
   }
-  if ( fPhysicsCase == "BERT"           ||
-       fPhysicsCase == "FTFP_BERT_ATL"  ||
-       fPhysicsCase == "FTFP_BERT"      ||
-       fPhysicsCase == "FTFP_INCLXX"    ||
-       fPhysicsCase == "QGSP_BERT"      ||
-       fPhysicsCase == "QGSP_BIC" ) {
+  if ( isKaonOrHyperon  &&
+       ( pc == PhysicsCase::BERT           ||
+         pc == PhysicsCase::FTFP_BERT_ATL  ||
+         pc == PhysicsCase::FTFP_BERT      ||
+         pc == PhysicsCase::FTFP_INCLXX    ||
+         pc == PhysicsCase::QGSP_BERT      ||
+         pc == PhysicsCase::QGSP_BIC ) ) {
     // The BERT model is used for kaons and hyperons in all physics lists
-    fPhysicsCaseIsSupported = true;
-    theKaonMinusInelasticProcess->RegisterMe( theBERTmodel );
-    theKaonPlusInelasticProcess->RegisterMe( theBERTmodel );
-    theKaonZeroLInelasticProcess->RegisterMe( theBERTmodel );
-    theKaonZeroSInelasticProcess->RegisterMe( theBERTmodel );
-    theLambdaInelasticProcess->RegisterMe( theBERTmodel );
-    theSigmaMinusInelasticProcess->RegisterMe( theBERTmodel );
-    theSigmaPlusInelasticProcess->RegisterMe( theBERTmodel );
-    theXiMinusInelasticProcess->RegisterMe( theBERTmodel );
-    theXiZeroInelasticProcess->RegisterMe( theBERTmodel );
-    theOmegaMinusInelasticProcess->RegisterMe( theBERTmodel );
+    theProcess->RegisterMe( GetModel( Model::BERT ) );
   }
-  if ( fPhysicsCase == "FTFP"           ||
-       fPhysicsCase == "FTFP_BERT_ATL"  ||
-       fPhysicsCase == "FTFP_BERT"      ||
-       fPhysicsCase == "FTFP_INCLXX"    ||
-       fPhysicsCase == "QGSP_BERT"      ||
-       fPhysicsCase == "QGSP_BIC" ) {
+  if ( pc == PhysicsCase::FTFP           ||
+       pc == PhysicsCase::FTFP_BERT_ATL  ||
+       pc == PhysicsCase::FTFP_BERT      ||
+       pc == PhysicsCase::FTFP_INCLXX    ||
+       pc == PhysicsCase::QGSP_BERT      ||
+       pc == PhysicsCase::QGSP_BIC ) {
     // The FTFP model is applied for all hadrons, but in different energy intervals according
     // whether it is consider as a stand-alone hadronic model, or within physics lists
-    fPhysicsCaseIsSupported = true;
-    theAntiDeuteronInelasticProcess->RegisterMe( theFTFPmodel );
-    theAntiTritonInelasticProcess->RegisterMe( theFTFPmodel );
-    theAntiHe3InelasticProcess->RegisterMe( theFTFPmodel );
-    theAntiAlphaInelasticProcess->RegisterMe( theFTFPmodel );
-    G4TheoFSGenerator* theFTFPmodelToBeUsed = theFTFPmodel_aboveThreshold;
-    if ( fPhysicsCase == "FTFP" ) {
-      theFTFPmodelToBeUsed = theFTFPmodel;
-    } else if ( fPhysicsCase == "QGSP_BERT"  ||  fPhysicsCase == "QGSP_BIC" ) {
-      theFTFPmodelToBeUsed = theFTFPmodel_constrained;
-    }	       
-    thePionMinusInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    thePionPlusInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theKaonMinusInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theKaonPlusInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theKaonZeroLInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theKaonZeroSInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theProtonInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theAntiProtonInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theNeutronInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theAntiNeutronInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theLambdaInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theAntiLambdaInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theSigmaMinusInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theAntiSigmaMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theSigmaPlusInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theAntiSigmaPlusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theXiMinusInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theAntiXiMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theXiZeroInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theAntiXiZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theOmegaMinusInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theAntiOmegaMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theDPlusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theDMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theDZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiDZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theDsPlusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theDsMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theBPlusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theBMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theBZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiBZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theBsZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiBsZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theBcPlusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theBcMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theLambdacPlusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiLambdacPlusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theXicPlusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiXicPlusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theXicZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiXicZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theOmegacZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiOmegacZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theLambdabInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiLambdabInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theXibZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiXibZeroInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theXibMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiXibMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theOmegabMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theAntiOmegabMinusInelasticProcess->RegisterMe( theFTFPmodel_belowThreshold );
-    theFTFPmodelToBeUsed = theFTFPmodel_aboveThreshold;
-    if ( fPhysicsCase == "FTFP" ) theFTFPmodelToBeUsed = theFTFPmodel;
-    theDeuteronInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theTritonInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theHe3InelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theAlphaInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
-    theIonInelasticProcess->RegisterMe( theFTFPmodelToBeUsed );
+    Model theFTFPmodelToBeUsed = Model::FTFP_aboveThreshold;
+    if ( group == ProjectileGroup::AntiIon ) {
+      theFTFPmodelToBeUsed = Model::FTFP;
+    } else if ( group == ProjectileGroup::AntiBaryon  ||
+                group == ProjectileGroup::HeavyFlavour ) {
+      theFTFPmodelToBeUsed = Model::FTFP_belowThreshold;
+    } else if ( pc == PhysicsCase::FTFP ) {
+      theFTFPmodelToBeUsed = Model::FTFP;
+    } else if ( group != ProjectileGroup::Ion  &&
+                ( pc == PhysicsCase::QGSP_BERT  ||  pc == PhysicsCase::QGSP_BIC ) ) {
+      theFTFPmodelToBeUsed = Model::FTFP_constrained;
+    }
+    theProcess->RegisterMe( GetModel( theFTFPmodelToBeUsed ) );
   }
+}
 
-  if ( ! fPhysicsCaseIsSupported ) {
-    G4cerr << "ERROR: Not supported final-state hadronic inelastic physics case !"
-           << fPhysicsCase << G4endl
-           << "\t Re-try by choosing one of the following:" << G4endl
-           << "\t - Hadronic models : BERT, BIC, IonBIC, INCL, FTFP, QGSP" << G4endl
-           << "\t - \"Physics-list proxies\" : FTFP_BERT (default), FTFP_BERT_ATL, \
-                                               QGSP_BERT, QGSP_BIC, FTFP_INCLXX"
-           << G4endl;
-  }
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4HadronicProcess* HadronicGenerator::GetProcess( const G4int projectileIndex ) {
+  // Set up the inelastic process of the projectile on first use: the process
+  // itself, its cross sections and the hadronic models it needs.
+  if ( fProcesses[ projectileIndex ] != nullptr ) return fProcesses[ projectileIndex ];
+  const Projectile& projectile = fProjectiles[ projectileIndex ];
+  const auto startTime = std::chrono::steady_clock::now();
+  G4HadronicProcess* theProcess =
+    new G4HadronInelasticProcess( projectile.fProcessName, projectile.fDefinition );
+  theProcess->AddDataSet( GetCrossSection( projectile.fCrossSection, projectile.fDefinition ) );
+  RegisterModels( theProcess, projectile.fGroup );
+  fProcesses[ projectileIndex ] = theProcess;
+  AddInitTime( projectile.fProcessName, startTime );
+  return theProcess;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-HadronicGenerator::~HadronicGenerator() {
-  fPartTable->DeleteAllParticles();
+G4bool HadronicGenerator::PrepareProjectile( G4ParticleDefinition* projectileDefinition ) {
+  return GetProjectileProcess( projectileDefinition ) != nullptr;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-G4bool HadronicGenerator::IsApplicable( const G4String &nameProjectile,
-                                        const G4double projectileEnergy ) const {
-  G4ParticleDefinition* projectileDefinition = fPartTable->FindParticle( nameProjectile );
-  return IsApplicable( projectileDefinition, projectileEnergy );
+G4HadronicProcess* HadronicGenerator::
+GetProjectileProcess( G4ParticleDefinition* projectileDefinition ) {
+  if ( projectileDefinition == nullptr ) return nullptr;
+  G4ParticleDefinition* theProjectileDef = projectileDefinition;
+  if ( projectileDefinition->IsGeneralIon() ) theProjectileDef = G4GenericIon::Definition();
+  const G4int index = fParticleIndex.Find( theProjectileDef );
+  return index >= 0 ? GetProcess( index ) : nullptr;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-G4bool HadronicGenerator::IsApplicable( G4ParticleDefinition* projectileDefinition,
-                                        const G4double projectileEnergy ) const {
-  if ( projectileDefinition == nullptr ) return false;
-  G4bool isApplicable = true;
+void HadronicGenerator::BuildApplicabilityTable() {
+  // Each particle in the table of the projectiles has a dense index, and the
+  // limitations of the physics case for it are translated into a kinetic energy
+  // interval (limits included). The particles without a dense index (e.g. the ions
+  // handled by the GenericIon process) use the default interval.
   // No restrictions for "physics list proxies" because they cover all hadron types and energies.
-  // For the individual models, instead, we need to consider their limitations. 
-  if ( fPhysicsCase == "BERT" ) {
+  // For the individual models, instead, we need to consider their limitations.
+  const G4double inf = std::numeric_limits< G4double >::infinity();
+  const EnergyRange anyEnergy = { -inf, inf };
+  const EnergyRange noEnergy = { inf, -inf };
+  auto below = [inf]( G4double energy ) {  // Strict upper limit
+    return EnergyRange{ -inf, std::nextafter( energy, -inf ) };
+  };
+  fDefaultApplicability = anyEnergy;
+  if ( fPhysicsCaseId == PhysicsCase::BERT  ||  fPhysicsCaseId == PhysicsCase::BIC  ||
+       fPhysicsCaseId == PhysicsCase::INCL  ||  fPhysicsCaseId == PhysicsCase::IonBIC ) {
+    fDefaultApplicability = noEnergy;
+  } else if ( fPhysicsCaseId == PhysicsCase::QGSP ) {
+    fDefaultApplicability = { 2.0*CLHEP::GeV, inf };
+  }
+  fApplicability.assign( fParticleIndex.GetSize(), fDefaultApplicability );
+  auto setRange = [this]( G4ParticleDefinition* particle, const EnergyRange &range ) {
+    const G4int index = fParticleIndex.Find( particle );
+    if ( index >= 0 ) fApplicability[ index ] = range;
+  };
+
+  if ( fPhysicsCaseId == PhysicsCase::BERT ) {
     // We consider BERT model below 15 GeV
-    if ( ( ( projectileDefinition != G4PionMinus::Definition()  ) &&
-           ( projectileDefinition != G4PionPlus::Definition()   ) &&
-           ( projectileDefinition != G4Proton::Definition()     ) &&
-           ( projectileDefinition != G4Neutron::Definition()    ) &&
-           ( projectileDefinition != G4Lambda::Definition()     ) &&
-           ( projectileDefinition != G4SigmaMinus::Definition() ) &&
-           ( projectileDefinition != G4SigmaPlus::Definition()  ) &&
-           ( projectileDefinition != G4XiMinus::Definition()    ) &&
-           ( projectileDefinition != G4XiZero::Definition()     ) &&
-           ( projectileDefinition != G4OmegaMinus::Definition() ) ) ||
-         ( projectileEnergy > 15.0*CLHEP::GeV ) ) {
-      isApplicable = false;
+    const std::vector< G4ParticleDefinition* > projectiles = {
+      G4PionMinus::Definition(), G4PionPlus::Definition(), G4Proton::Definition(),
+      G4Neutron::Definition(), G4Lambda::Definition(), G4SigmaMinus::Definition(),
+      G4SigmaPlus::Definition(), G4XiMinus::Definition(), G4XiZero::Definition(),
+      G4OmegaMinus::Definition() };
+    for ( G4ParticleDefinition* particle : projectiles ) {
+      setRange( particle, { -inf, 15.0*CLHEP::GeV } );
     }
-  } else if ( fPhysicsCase == "QGSP" ) {
+  } else if ( fPhysicsCaseId == PhysicsCase::QGSP ) {
     // We consider QGSP above 2 GeV and not for ions or anti-ions
-    if ( projectileEnergy < 2.0*CLHEP::GeV                    ||
-         projectileDefinition == G4Deuteron::Definition()     ||
-         projectileDefinition == G4Triton::Definition()       ||
-         projectileDefinition == G4He3::Definition()          ||
-         projectileDefinition == G4Alpha::Definition()        ||
-         projectileDefinition == G4GenericIon::Definition()   ||
-         projectileDefinition == G4AntiDeuteron::Definition() ||
-         projectileDefinition == G4AntiTriton::Definition()   ||
-         projectileDefinition == G4AntiHe3::Definition()      ||
-         projectileDefinition == G4AntiAlpha::Definition() ) {
-      isApplicable = false;
+    const std::vector< G4ParticleDefinition* > projectiles = {
+      G4Deuteron::Definition(), G4Triton::Definition(), G4He3::Definition(),
+      G4Alpha::Definition(), G4GenericIon::Definition(), G4AntiDeuteron::Definition(),
+      G4AntiTriton::Definition(), G4AntiHe3::Definition(), G4AntiAlpha::Definition() };
+    for ( G4ParticleDefinition* particle : projectiles ) {
+      setRange( particle, noEnergy );
     }
-  } else if ( fPhysicsCase == "BIC"  ||  fPhysicsCase == "INCL" ) {
+  } else if ( fPhysicsCaseId == PhysicsCase::BIC  ||  fPhysicsCaseId == PhysicsCase::INCL ) {
     // We consider BIC and INCL models only for pions and nucleons below 10 GeV
     // (although in recent versions INCL is capable of handling more hadrons
     // and up to higher energies)
-    if ( ( ( projectileDefinition != G4PionMinus::Definition() ) &&
-           ( projectileDefinition != G4PionPlus::Definition()  ) &&
-           ( projectileDefinition != G4Proton::Definition()    ) &&
-           ( projectileDefinition != G4Neutron::Definition()   ) ) ||
-         ( projectileEnergy > 10.0*CLHEP::GeV ) ) {
-      isApplicable = false;
+    const std::vector< G4ParticleDefinition* > projectiles = {
+      G4PionMinus::Definition(), G4PionPlus::Definition(), G4Proton::Definition(),
+      G4Neutron::Definition() };
+    for ( G4ParticleDefinition* particle : projectiles ) {
+      setRange( particle, { -inf, 10.0*CLHEP::GeV } );
     }
-  } else if ( fPhysicsCase == "IonBIC" ) {
+  } else if ( fPhysicsCaseId == PhysicsCase::IonBIC ) {
     // We consider IonBIC models only for deuteron, triton, He3, alpha
     // with energies below 10 GeV / nucleon
-    if ( ! ( ( projectileDefinition == G4Deuteron::Definition()  &&
-               projectileEnergy < 2*10.0*CLHEP::GeV                 ) ||
-             ( projectileDefinition == G4Triton::Definition()    &&
-               projectileEnergy < 3*10.0*CLHEP::GeV                 ) ||
-             ( projectileDefinition == G4He3::Definition()       &&
-               projectileEnergy < 3*10.0*CLHEP::GeV                 ) ||
-             ( projectileDefinition == G4Alpha::Definition()     &&
-               projectileEnergy < 4*10.0*CLHEP::GeV                 ) ) ) {
-      isApplicable = false;
-    }
-  } 
-  return isApplicable;
+    setRange( G4Deuteron::Definition(), below( 2*10.0*CLHEP::GeV ) );
+    setRange( G4Triton::Definition(),   below( 3*10.0*CLHEP::GeV ) );
+    setRange( G4He3::Definition(),      below( 3*10.0*CLHEP::GeV ) );
+    setRange( G4Alpha::Definition(),    below( 4*10.0*CLHEP::GeV ) );
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HadronicGenerator::~HadronicGenerator() {
+  ReleaseInteraction();
+  delete fStep;
+  delete fTrack;
+  // The particles, processes, models and cross-section datasets are owned by the
+  // Geant4 tables and registries, shared with the other generators of the process.
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool HadronicGenerator::IsApplicable( const G4String &nameProjectile,
+                                        const G4double projectileEnergy ) const {
+  G4ParticleDefinition* projectileDefinition = fPartTable->FindParticle( nameProjectile );
+  return IsApplicable( projectileDefinition, projectileEnergy );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool HadronicGenerator::IsApplicable( G4ParticleDefinition* projectileDefinition,
+                                        const G4double projectileEnergy ) const {
+  if ( projectileDefinition == nullptr ) return false;
+  // See BuildApplicabilityTable for the limitations of each physics case.
+  return IsApplicableIndex( fParticleIndex.Find( projectileDefinition ), projectileEnergy );
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -964,10 +913,13 @@ GenerateInteraction( G4ParticleDefinition* projectileDefinition, const G4double
   // the method performs the specified hadronic interaction
   // (by invoking the "PostStepDoIt" method of the corresponding hadronic process)
   // and returns the final state, i.e. the secondaries produced by the collision.
-  // It is a relatively short method because the heavy load of setting up all
-  // possible hadronic processes - with their hadronic models, transition regions,
+  // It is a relatively short method because the heavy load of setting up the
+  // hadronic process of the projectile - with its hadronic models, transition regions,
   // and cross sections (the latter is needed for sampling the target nucleus from
-  // the target material) - was already done by the constructor of the class.
+  // the target material) - is done only once, by PrepareProjectile or by the first
+  // call for that projectile.
+  // The final state of the previous call is released first.
+  ReleaseInteraction();
   G4VParticleChange* aChange = nullptr;
 
   if ( projectileDefinition == nullptr ) {
@@ -980,7 +932,18 @@ GenerateInteraction( G4ParticleDefinition* projectileDefinition, const G4double
   //       << "\t" << projectileEnergy/CLHEP::GeV
   //       << " GeV \t" << projectileDirection
   //       << "\t" << ( targetMaterial ? targetMaterial->GetName() : "NULL" );
-  if ( ! IsApplicable( projectileDefinition, projectileEnergy ) ) {
+
+  // Dense indices of the projectile and of its process (the one of GenericIon for
+  // ions): they are cached, because the same projectile is typically requested
+  // many times in a row, and then the per-call lookups are only array accesses.
+  if ( projectileDefinition != fLastProjectile ) {
+    G4ParticleDefinition* theProjectileDef = projectileDefinition;
+    if ( projectileDefinition->IsGeneralIon() ) theProjectileDef = G4GenericIon::Definition();
+    fLastProjectile = projectileDefinition;
+    fLastProjectileIndex = fParticleIndex.Find( projectileDefinition );
+    fLastProcessIndex = fParticleIndex.Find( theProjectileDef );
+  }
+  if ( ! IsApplicableIndex( fLastProjectileIndex, projectileEnergy ) ) {
     //G4cout << " -> NOT applicable !" ; //<< G4endl;  // Debugging print-out
     return aChange;
   }
@@ -1001,23 +964,16 @@ GenerateInteraction( G4ParticleDefinition* projectileDefinition, const G4double
   //G4PVPlacement* pFrame = new G4PVPlacement( 0, G4ThreeVector(), "Box", lFrame, 0, false, 0 );
   //G4TransportationManager::GetTransportationManager()->SetWorldForTracking( pFrame );
 
-  // Projectile track & step
-  G4DynamicParticle dParticle( projectileDefinition, projectileDirection, projectileEnergy );
+  // Projectile track & step: reset in place the ones created in the constructor
   const G4double aTime = 0.0;
   const G4ThreeVector aPosition = G4ThreeVector( 0.0, 0.0, 0.0 );
-  G4Track* gTrack = new G4Track( &dParticle, aTime, aPosition );
-  G4TouchableHandle fpTouchable( new G4TouchableHistory );  // Not strictly needed
-  gTrack->SetTouchableHandle( fpTouchable );                // Not strictly needed
-  G4Step* step = new G4Step;
-  step->SetTrack( gTrack );
-  gTrack->SetStep( step );
-  G4StepPoint* aPoint = new G4StepPoint;
-  aPoint->SetPosition( aPosition );
-  aPoint->SetMaterial( targetMaterial );
-  step->SetPreStepPoint( aPoint );
-  dParticle.SetKineticEnergy( projectileEnergy );
-  gTrack->SetStep( step );
-  gTrack->SetKineticEnergy( projectileEnergy );
+  fDynamicParticle->SetDefinition( projectileDefinition );
+  fDynamicParticle->SetMomentumDirection( projectileDirection );
+  fDynamicParticle->SetKineticEnergy( projectileEnergy );
+  fTrack->SetPosition( aPosition );
+  fTrack->SetGlobalTime( aTime );
+  fTrack->SetTrackStatus( fAlive );
+  fStep->GetPreStepPoint()->SetMaterial( targetMaterial );
 
   // Change Geant4 state: from "PreInit" to "Idle" (not strictly needed)
   //if ( ! G4StateManager::GetStateManager()->SetNewState( G4State_Idle ) ) {
@@ -1026,23 +982,33 @@ GenerateInteraction( G4ParticleDefinition* projectileDefinition, const G4double
   //}
 
   // Finally, the hadronic interaction: hadron projectile and ion projectile
-  // need to be treated slightly differently
+  // need to be treated slightly differently (see the process index above)
   G4HadronicProcess* theProcess = nullptr;
-  G4ParticleDefinition* theProjectileDef = nullptr;
-  if ( projectileDefinition->IsGeneralIon() ) {
-    theProjectileDef = G4GenericIon::Definition();
-  } else {
-    theProjectileDef = projectileDefinition;
+  if ( fLastProcessIndex >= 0 ) {
+    theProcess = fProcesses[ fLastProcessIndex ];
+    if ( theProcess == nullptr ) theProcess = GetProcess( fLastProcessIndex );  // Set up on first use
   }
-  auto mapIndex = fProcessMap.find( theProjectileDef );
-  if ( mapIndex != fProcessMap.end() ) theProcess = mapIndex->second;
-  if ( theProcess != nullptr ) {
-    aChange = theProcess->PostStepDoIt( *gTrack, *step );
+  if ( theProcess != nullptr && fProfiler != nullptr ) {
+    const auto startTime = std::chrono::steady_clock::now();
+    aChange = theProcess->PostStepDoIt( *fTrack, *fStep );
+    const auto stopTime = std::chrono::steady_clock::now();
+    #if G4VERSION_NUMBER >= 1100
+    const G4HadronicInteraction* theModel = theProcess->GetHadronicInteraction();
+    #else
+    const G4HadronicInteraction* theModel = nullptr;
+    #endif
+    fProfiler->Record( theProcess, theModel,
+                       std::chrono::duration_cast< std::chrono::nanoseconds >
+                         ( stopTime - startTime ).count(),
+                       aChange != nullptr ? aChange->GetNumberOfSecondaries() : 0 );
+  } else if ( theProcess != nullptr ) {
+    aChange = theProcess->PostStepDoIt( *fTrack, *fStep );
     //**************************************************
   } else {
     G4cerr << "ERROR: theProcess is nullptr !" << G4endl;
   }
   fLastHadronicProcess = theProcess;
+  fLastChange = aChange;
   //delete pFrame;
   //delete lFrame;
   //delete sFrame;
@@ -1050,6 +1016,122 @@ GenerateInteraction( G4ParticleDefinition* projectileDefinition, const G4double
   return aChange;
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int HadronicGenerator::
+GenerateInteractions( G4ParticleDefinition* projectileDefinition, const G4double projectileEnergy,
+                      const G4ThreeVector &projectileDirection, G4Material* targetMaterial,
+                      const G4int nInteractions, SecondariesBuffer &secondaries,
+                      const std::function< void( G4int ) > &beginInteraction ) {
+  // The secondaries are copied into flat columns, so that the caller can loop over
+  // them without going through G4Track -> G4DynamicParticle -> G4ParticleDefinition
+  // for each of them.
+  secondaries.Clear();
+  for ( G4int i = 0; i < nInteractions; ++i ) {
+    if ( beginInteraction ) beginInteraction( i );
+    G4VParticleChange* aChange = GenerateInteraction( projectileDefinition, projectileEnergy,
+                                                      projectileDirection, targetMaterial );
+    if ( aChange == nullptr ) return i;
+    const G4int nSecondaries = aChange->GetNumberOfSecondaries();
+    for ( G4int j = 0; j < nSecondaries; ++j ) {
+      G4Track* secondaryTrack = aChange->GetSecondary( j );
+      const G4DynamicParticle* particle = secondaryTrack->GetDynamicParticle();
+      const G4LorentzVector p = particle->Get4Momentum();
+      secondaries.AddSecondary( particle->GetDefinition()->GetPDGEncoding(),
+                                p.px(), p.py(), p.pz(), p.e(),
+                                particle->GetKineticEnergy() );
+    }
+    ReleaseInteraction();
+    const G4Nucleus* target = fLastHadronicProcess->GetTargetNucleus();
+    secondaries.CloseInteraction( target->GetZ_asInt(), target->GetA_asInt() );
+  }
+  return nInteractions;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HadronicGenerator::ReleaseInteraction() {
+  if ( fLastChange == nullptr ) return;
+  const G4int nSecondaries = fLastChange->GetNumberOfSecondaries();
+  for ( G4int j = 0; j < nSecondaries; ++j ) {
+    delete fLastChange->GetSecondary( j );  // It deletes also its dynamic particle
+  }
+  fLastChange->Clear();
+  fLastChange = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const CrossSectionTable* HadronicGenerator::
+GetElementTable( G4ParticleDefinition* projectileDefinition, const G4int Z ) {
+  // Tabulate the element cross section through the process, i.e. with the same
+  // datasets as the sampling of the target nucleus. The simple material of the
+  // element is given to the datasets that need a material.
+  const auto key = std::make_pair( projectileDefinition, Z );
+  auto entry = fElementTables.find( key );
+  if ( entry != fElementTables.end() ) return &entry->second;
+  G4HadronicProcess* theProcess = GetProjectileProcess( projectileDefinition );
+  if ( theProcess == nullptr ) return nullptr;
+  const G4Element* element = G4NistManager::Instance()->FindOrBuildElement( Z );
+  const G4Material* material = G4NistManager::Instance()->FindOrBuildSimpleMaterial( Z );
+  if ( element == nullptr ) return nullptr;
+  CrossSectionTable table( 1.0*CLHEP::keV, 1000.0*CLHEP::TeV, 50 );
+  G4DynamicParticle dynamicParticle( projectileDefinition, G4ThreeVector( 0.0, 0.0, 1.0 ),
+                                     table.GetEnergy( 0 ) );
+  for ( std::size_t i = 0; i < table.GetNPoints(); ++i ) {
+    dynamicParticle.SetKineticEnergy( table.GetEnergy( i ) );
+    table.SetValue( i, theProcess->GetElementCrossSection( &dynamicParticle, element,
+                                                           material ) );
+  }
+  return &fElementTables.emplace( key, std::move( table ) ).first->second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const CrossSectionTable* HadronicGenerator::
+GetMaterialTable( G4ParticleDefinition* projectileDefinition,
+                  const G4Material* targetMaterial ) {
+  // Macroscopic cross section: sum of the element tables weighted by the number of
+  // atoms per volume, exact at the grid points (the interpolation is linear).
+  const auto key = std::make_pair( projectileDefinition, targetMaterial );
+  auto entry = fMaterialTables.find( key );
+  if ( entry != fMaterialTables.end() ) return &entry->second;
+  CrossSectionTable table( 1.0*CLHEP::keV, 1000.0*CLHEP::TeV, 50 );
+  const G4double* atomsPerVolume = targetMaterial->GetVecNbOfAtomsPerVolume();
+  for ( std::size_t e = 0; e < targetMaterial->GetNumberOfElements(); ++e ) {
+    const CrossSectionTable* elementTable =
+      GetElementTable( projectileDefinition, targetMaterial->GetElement( e )->GetZasInt() );
+    if ( elementTable == nullptr ) return nullptr;
+    table.Add( *elementTable, atomsPerVolume[ e ] );
+  }
+  return &fMaterialTables.emplace( key, std::move( table ) ).first->second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool HadronicGenerator::
+GetElementCrossSections( G4ParticleDefinition* projectileDefinition, const G4int Z,
+                         const G4double* energies, const std::size_t n,
+                         G4double* crossSections ) {
+  const CrossSectionTable* table = GetElementTable( projectileDefinition, Z );
+  if ( table == nullptr ) return false;
+  table->Evaluate( energies, n, crossSections );
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool HadronicGenerator::
+GetMaterialCrossSections( G4ParticleDefinition* projectileDefinition,
+                          const G4Material* targetMaterial, const G4double* energies,
+                          const std::size_t n, G4double* crossSections ) {
+  if ( targetMaterial == nullptr ) return false;
+  const CrossSectionTable* table = GetMaterialTable( projectileDefinition, targetMaterial );
+  if ( table == nullptr ) return false;
+  table->Evaluate( energies, n, crossSections );
+  return true;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 /*
 G4double HadronicGenerator::GetImpactParameter() const {
@@ -0,0 +1,80 @@
+//**************************************************
+// \file HistoAccumulator.cc
+// \brief: Implementation of H1Accumulator and H2Accumulator classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "HistoAccumulator.hh"
+#include "G4ios.hh"
+
+HistoAxis::HistoAxis(G4int nBins, G4double min, G4double max)
+    : fNBins(nBins), fMin(min), fMax(max), fBinsPerUnit(nBins / (max - min)) {
+}
+
+void H1Accumulator::Add(const H1Accumulator &other) {
+  for (std::size_t i = 0; i < fBins.size(); i++) {
+    fBins[i].entries += other.fBins[i].entries;
+    fBins[i].sw += other.fBins[i].sw;
+    fBins[i].sw2 += other.fBins[i].sw2;
+    fBins[i].sxw += other.fBins[i].sxw;
+    fBins[i].sx2w += other.fBins[i].sx2w;
+  }
+}
+
+G4bool H1Accumulator::WriteTo(tools::histo::h1d &histo) const {
+  if (histo.axis().bins() != static_cast<unsigned int>(fAxis.GetNBins())) {
+    G4cerr << "H1Accumulator: binning differs from the histogram" << G4endl;
+    return false;
+  }
+  // Bin 0 is the underflow and bin nBins + 1 the overflow, as in g4tools.
+  // Every bin is set, so that nothing is left of a previous content
+  //
+  for (std::size_t i = 0; i < fBins.size(); i++) {
+    const Bin &bin = fBins[i];
+    if (!histo.set_bin_content(static_cast<unsigned int>(i),
+                               static_cast<unsigned int>(bin.entries), bin.sw,
+                               bin.sw2, bin.sxw, bin.sx2w)) {
+      G4cerr << "H1Accumulator: cannot set bin " << i << G4endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+void H2Accumulator::Add(const H2Accumulator &other) {
+  for (std::size_t i = 0; i < fBins.size(); i++) {
+    fBins[i].entries += other.fBins[i].entries;
+    fBins[i].sw += other.fBins[i].sw;
+    fBins[i].sw2 += other.fBins[i].sw2;
+    fBins[i].sxw += other.fBins[i].sxw;
+    fBins[i].sx2w += other.fBins[i].sx2w;
+    fBins[i].syw += other.fBins[i].syw;
+    fBins[i].sy2w += other.fBins[i].sy2w;
+  }
+}
+
+G4bool H2Accumulator::WriteTo(tools::histo::h2d &histo) const {
+  if (histo.axis_x().bins() != static_cast<unsigned int>(fAxisX.GetNBins()) ||
+      histo.axis_y().bins() != static_cast<unsigned int>(fAxisY.GetNBins())) {
+    G4cerr << "H2Accumulator: binning differs from the histogram" << G4endl;
+    return false;
+  }
+  const std::size_t nX = fAxisX.GetNBins() + 2;
+  for (std::size_t i = 0; i < fBins.size(); i++) {
+    const Bin &bin = fBins[i];
+    if (!histo.set_bin_content(static_cast<unsigned int>(i % nX),
+                               static_cast<unsigned int>(i / nX),
+                               static_cast<unsigned int>(bin.entries), bin.sw,
+                               bin.sw2, bin.sxw, bin.sx2w, bin.syw,
+                               bin.sy2w)) {
+      G4cerr << "H2Accumulator: cannot set bin " << i % nX << ", " << i / nX
+             << G4endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//**************************************************
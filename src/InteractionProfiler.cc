@@ -0,0 +1,112 @@
+//**************************************************
+// \file InteractionProfiler.cc
+// \brief: Implementation of InteractionProfiler class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "InteractionProfiler.hh"
+#include "G4HadronicInteraction.hh"
+#include "G4HadronicProcess.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+std::vector<const InteractionProfiler::Entry *>
+SortByTime(const std::vector<InteractionProfiler::Entry> &entries) {
+  std::vector<const InteractionProfiler::Entry *> sorted;
+  for (const auto &entry : entries) {
+    sorted.push_back(&entry);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto *a, const auto *b) {
+    return a->nanoseconds > b->nanoseconds;
+  });
+  return sorted;
+}
+} // namespace
+
+InteractionProfiler::Entry &
+InteractionProfiler::AddEntry(const G4HadronicProcess *process,
+                              const G4HadronicInteraction *model) {
+  const G4String processName =
+      process == nullptr ? G4String("unknown") : process->GetProcessName();
+  const G4String modelName =
+      model == nullptr ? G4String("unknown") : model->GetModelName();
+  fEntries.push_back({process, model, processName, modelName, 0, 0, 0});
+  return fEntries.back();
+}
+
+void InteractionProfiler::Merge(const InteractionProfiler &other) {
+  for (const Entry &otherEntry : other.fEntries) {
+    auto entry = std::find_if(
+        fEntries.begin(), fEntries.end(), [&](const Entry &candidate) {
+          return candidate.processName == otherEntry.processName &&
+                 candidate.modelName == otherEntry.modelName;
+        });
+    if (entry == fEntries.end()) {
+      fEntries.push_back(otherEntry);
+      continue;
+    }
+    entry->calls += otherEntry.calls;
+    entry->nanoseconds += otherEntry.nanoseconds;
+    entry->secondaries += otherEntry.secondaries;
+  }
+}
+
+void InteractionProfiler::Print() const {
+  std::uint64_t totalNanoseconds = 0;
+  for (const Entry &entry : fEntries) {
+    totalNanoseconds += entry.nanoseconds;
+  }
+  G4cout << "=================  Interaction profile  =================="
+         << G4endl << std::left << std::setw(18) << "process"
+         << std::setw(24) << "model" << std::right << std::setw(10)
+         << "calls" << std::setw(10) << "time(s)" << std::setw(8) << "time%"
+         << std::setw(10) << "us/call" << std::setw(10) << "<nsec>" << G4endl;
+  for (const Entry *entry : SortByTime(fEntries)) {
+    const G4double seconds = entry->nanoseconds * 1e-9;
+    G4cout << std::left << std::setw(18) << entry->processName
+           << std::setw(24) << entry->modelName << std::right
+           << std::setw(10) << entry->calls << std::setw(10)
+           << std::setprecision(4) << seconds << std::setw(8)
+           << std::setprecision(3)
+           << (totalNanoseconds > 0
+                   ? 100. * entry->nanoseconds / totalNanoseconds
+                   : 0.)
+           << std::setw(10) << std::setprecision(4)
+           << (entry->calls > 0 ? entry->nanoseconds * 1e-3 / entry->calls
+                                : 0.)
+           << std::setw(10)
+           << (entry->calls > 0 ? G4double(entry->secondaries) / entry->calls
+                                : 0.)
+           << G4endl;
+  }
+  G4cout << std::setprecision(6)
+         << "==========================================================="
+         << G4endl;
+}
+
+G4bool InteractionProfiler::WriteJSON(const G4String &fileName) const {
+  std::ofstream file(fileName);
+  if (!file) {
+    G4cerr << "InteractionProfiler: cannot open " << fileName << G4endl;
+    return false;
+  }
+  file << "{\n  \"entries\": [";
+  G4bool first = true;
+  for (const Entry *entry : SortByTime(fEntries)) {
+    file << (first ? "\n" : ",\n") << "    {\"process\": \""
+         << entry->processName << "\", \"model\": \"" << entry->modelName
+         << "\", \"calls\": " << entry->calls
+         << ", \"nanoseconds\": " << entry->nanoseconds
+         << ", \"secondaries\": " << entry->secondaries << "}";
+    first = false;
+  }
+  file << "\n  ]\n}\n";
+  return true;
+}
+
+//**************************************************
@@ -0,0 +1,190 @@
+//**************************************************
+// \file NtupleWriter.cc
+// \brief: Implementation of NtupleWriter and NtupleBuffer classes
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "NtupleWriter.hh"
+#include "G4ios.hh"
+
+namespace {
+template <typename T> void WriteValue(std::ofstream &file, const T &value) {
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+void WriteColumn(std::ofstream &file, const std::vector<T> &column) {
+  file.write(reinterpret_cast<const char *>(column.data()),
+             sizeof(T) * column.size());
+}
+
+void WriteColumnDescription(std::ofstream &file, std::uint8_t size,
+                            char kind, const std::string &name) {
+  WriteValue(file, size);
+  WriteValue(file, kind);
+  WriteValue(file, static_cast<std::uint8_t>(name.size()));
+  file.write(name.data(), name.size());
+}
+} // namespace
+
+void NtupleWriter::Chunk::Reserve(std::size_t rows) {
+  event.reserve(rows);
+  pdg.reserve(rows);
+  px.reserve(rows);
+  py.reserve(rows);
+  pz.reserve(rows);
+  e.reserve(rows);
+  ekin.reserve(rows);
+  model.reserve(rows);
+  targetZ.reserve(rows);
+  targetA.reserve(rows);
+  projectileEkin.reserve(rows);
+}
+
+void NtupleWriter::Chunk::Clear() {
+  event.clear();
+  pdg.clear();
+  px.clear();
+  py.clear();
+  pz.clear();
+  e.clear();
+  ekin.clear();
+  model.clear();
+  targetZ.clear();
+  targetA.clear();
+  projectileEkin.clear();
+}
+
+NtupleWriter::~NtupleWriter() { Close(); }
+
+G4bool NtupleWriter::Open(const G4String &fileName, const G4String &metadata) {
+  fFile.open(fileName, std::ios::binary | std::ios::trunc);
+  if (!fFile) {
+    G4cerr << "NtupleWriter: cannot open " << fileName << G4endl;
+    return false;
+  }
+  fFile.write("G4HFSNT1", 8);
+  WriteValue(fFile, static_cast<std::uint32_t>(metadata.size()));
+  fFile.write(metadata.data(), metadata.size());
+  WriteValue(fFile, static_cast<std::uint32_t>(11));
+  WriteColumnDescription(fFile, 8, 'u', "event");
+  WriteColumnDescription(fFile, 4, 'i', "pdg");
+  WriteColumnDescription(fFile, 8, 'f', "px");
+  WriteColumnDescription(fFile, 8, 'f', "py");
+  WriteColumnDescription(fFile, 8, 'f', "pz");
+  WriteColumnDescription(fFile, 8, 'f', "e");
+  WriteColumnDescription(fFile, 8, 'f', "ekin");
+  WriteColumnDescription(fFile, 2, 'i', "model");
+  WriteColumnDescription(fFile, 2, 'i', "targetZ");
+  WriteColumnDescription(fFile, 2, 'i', "targetA");
+  WriteColumnDescription(fFile, 8, 'f', "projectile_ekin");
+  fModels.clear();
+  fClosing = false;
+  fThread = std::thread(&NtupleWriter::WriteLoop, this);
+  return true;
+}
+
+void NtupleWriter::Close() {
+  if (!fThread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fClosing = true;
+  }
+  fCondition.notify_one();
+  fThread.join();
+  fFile.write("MODL", 4);
+  WriteValue(fFile, static_cast<std::uint32_t>(fModels.size()));
+  for (const G4String &model : fModels) {
+    WriteValue(fFile, static_cast<std::uint16_t>(model.size()));
+    fFile.write(model.data(), model.size());
+  }
+  fFile.write("END!", 4);
+  fFile.close();
+}
+
+std::int16_t NtupleWriter::RegisterModel(const G4String &modelName) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (std::size_t i = 0; i < fModels.size(); i++) {
+    if (fModels[i] == modelName) {
+      return static_cast<std::int16_t>(i);
+    }
+  }
+  fModels.push_back(modelName);
+  return static_cast<std::int16_t>(fModels.size() - 1);
+}
+
+std::unique_ptr<NtupleWriter::Chunk> NtupleWriter::GetChunk() {
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fFreeChunks.empty()) {
+      std::unique_ptr<Chunk> chunk = std::move(fFreeChunks.back());
+      fFreeChunks.pop_back();
+      return chunk;
+    }
+  }
+  // No free chunk: allocate one. The number of chunks stays bounded, as
+  // Submit blocks when the queue is full
+  //
+  std::unique_ptr<Chunk> chunk(new Chunk);
+  chunk->Reserve(chunkRows);
+  return chunk;
+}
+
+void NtupleWriter::Submit(std::unique_ptr<Chunk> chunk) {
+  {
+    std::unique_lock<std::mutex> lock(fMutex);
+    fSpace.wait(lock, [&] { return fQueue.size() < maxQueuedChunks; });
+    fQueue.push_back(std::move(chunk));
+  }
+  fCondition.notify_one();
+}
+
+void NtupleWriter::WriteLoop() {
+  std::unique_lock<std::mutex> lock(fMutex);
+  while (true) {
+    fCondition.wait(lock, [&] { return fClosing || !fQueue.empty(); });
+    if (fQueue.empty()) {
+      return; // closing and nothing left to write
+    }
+    std::unique_ptr<Chunk> chunk = std::move(fQueue.front());
+    fQueue.pop_front();
+    lock.unlock();
+    fSpace.notify_all();
+    WriteChunk(*chunk);
+    chunk->Clear();
+    lock.lock();
+    fFreeChunks.push_back(std::move(chunk));
+  }
+}
+
+void NtupleWriter::WriteChunk(const Chunk &chunk) {
+  if (chunk.GetRows() == 0) {
+    return;
+  }
+  fFile.write("CHNK", 4);
+  WriteValue(fFile, static_cast<std::uint64_t>(chunk.GetRows()));
+  WriteColumn(fFile, chunk.event);
+  WriteColumn(fFile, chunk.pdg);
+  WriteColumn(fFile, chunk.px);
+  WriteColumn(fFile, chunk.py);
+  WriteColumn(fFile, chunk.pz);
+  WriteColumn(fFile, chunk.e);
+  WriteColumn(fFile, chunk.ekin);
+  WriteColumn(fFile, chunk.model);
+  WriteColumn(fFile, chunk.targetZ);
+  WriteColumn(fFile, chunk.targetA);
+  WriteColumn(fFile, chunk.projectileEkin);
+}
+
+void NtupleBuffer::Flush() {
+  if (fChunk != nullptr && fChunk->GetRows() > 0) {
+    fWriter->Submit(std::move(fChunk));
+    fChunk = fWriter->GetChunk();
+  }
+}
+
+//**************************************************
@@ -0,0 +1,163 @@
+//**************************************************
+// \file SeedJournal.cc
+// \brief: Implementation of SeedJournal class
+// \author: Lorenzo Pezzotti (CERN EP-SFT-sim)
+//          @lopezzot
+// \start date: 17 October 2026
+//**************************************************
+
+#include "SeedJournal.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+#include <algorithm>
+
+namespace {
+const char headerMagic[8] = {'G', '4', 'H', 'F', 'S', 'S', 'J', '1'};
+const char footerMagic[8] = {'G', '4', 'H', 'F', 'S', 'S', 'J', 'E'};
+const std::uint64_t headerSize = 16;
+const std::uint64_t footerSize = 24;
+} // namespace
+
+G4bool SeedJournal::OpenForWriting(const G4String &fileName,
+                                   const CLHEP::HepRandomEngine &engine) {
+  fFile.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!fFile) {
+    G4cerr << "SeedJournal: cannot open " << fileName << G4endl;
+    return false;
+  }
+  fWriting = true;
+  fStateSize = engine.put().size();
+  fIndex.clear();
+  fFile.write(headerMagic, sizeof(headerMagic));
+  fFile.write(reinterpret_cast<const char *>(&fStateSize), sizeof(fStateSize));
+  return true;
+}
+
+void SeedJournal::Record(std::uint64_t event,
+                         const CLHEP::HepRandomEngine &engine) {
+  const std::vector<unsigned long> state = engine.put();
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (state.size() != fStateSize) {
+    G4cerr << "SeedJournal: engine state of event " << event
+           << " has a different size, not recorded" << G4endl;
+    return;
+  }
+  fRecord.assign(1, event);
+  fRecord.insert(fRecord.end(), state.begin(), state.end());
+  fIndex.emplace_back(event, headerSize + fIndex.size() * fRecord.size() *
+                                               sizeof(std::uint64_t));
+  fFile.write(reinterpret_cast<const char *>(fRecord.data()),
+              fRecord.size() * sizeof(std::uint64_t));
+}
+
+void SeedJournal::Close() {
+  if (!fFile.is_open()) {
+    return;
+  }
+  if (fWriting) {
+    std::sort(fIndex.begin(), fIndex.end());
+    const std::uint64_t indexOffset =
+        headerSize + fIndex.size() * (1 + fStateSize) * sizeof(std::uint64_t);
+    const std::uint64_t nRecords = fIndex.size();
+    for (const auto &entry : fIndex) {
+      fFile.write(reinterpret_cast<const char *>(&entry.first),
+                  sizeof(std::uint64_t));
+      fFile.write(reinterpret_cast<const char *>(&entry.second),
+                  sizeof(std::uint64_t));
+    }
+    fFile.write(reinterpret_cast<const char *>(&indexOffset),
+                sizeof(indexOffset));
+    fFile.write(reinterpret_cast<const char *>(&nRecords), sizeof(nRecords));
+    fFile.write(footerMagic, sizeof(footerMagic));
+    fWriting = false;
+  }
+  fFile.close();
+}
+
+G4bool SeedJournal::OpenForReading(const G4String &fileName) {
+  fFile.open(fileName, std::ios::in | std::ios::binary);
+  if (!fFile) {
+    G4cerr << "SeedJournal: cannot open " << fileName << G4endl;
+    return false;
+  }
+  fWriting = false;
+  char magic[8];
+  std::uint64_t indexOffset = 0;
+  std::uint64_t nRecords = 0;
+  fFile.read(magic, sizeof(magic));
+  fFile.read(reinterpret_cast<char *>(&fStateSize), sizeof(fStateSize));
+  const G4bool validHeader =
+      fFile && std::equal(magic, magic + sizeof(magic), headerMagic);
+  fFile.seekg(-static_cast<std::streamoff>(footerSize), std::ios::end);
+  fFile.read(reinterpret_cast<char *>(&indexOffset), sizeof(indexOffset));
+  fFile.read(reinterpret_cast<char *>(&nRecords), sizeof(nRecords));
+  fFile.read(magic, sizeof(magic));
+  if (!validHeader || fStateSize == 0) {
+    G4cerr << "SeedJournal: " << fileName << " is not a seed journal"
+           << G4endl;
+    fFile.close();
+    return false;
+  }
+  if (!fFile || !std::equal(magic, magic + sizeof(magic), footerMagic)) {
+    G4cout << "SeedJournal: " << fileName
+           << " has no index (run not closed), scanning the records"
+           << G4endl;
+    return ScanRecords();
+  }
+  fIndex.resize(nRecords);
+  fFile.seekg(indexOffset);
+  for (auto &entry : fIndex) {
+    fFile.read(reinterpret_cast<char *>(&entry.first), sizeof(std::uint64_t));
+    fFile.read(reinterpret_cast<char *>(&entry.second),
+               sizeof(std::uint64_t));
+  }
+  return static_cast<G4bool>(fFile);
+}
+
+G4bool SeedJournal::ScanRecords() {
+  // Records have a fixed size: read the event of each complete record, a
+  // record cut by the end of the file is ignored
+  //
+  fFile.clear();
+  fFile.seekg(0, std::ios::end);
+  const std::uint64_t fileSize = fFile.tellg();
+  const std::uint64_t recordSize = (1 + fStateSize) * sizeof(std::uint64_t);
+  const std::uint64_t nRecords =
+      fileSize > headerSize ? (fileSize - headerSize) / recordSize : 0;
+  fIndex.clear();
+  fIndex.reserve(nRecords);
+  for (std::uint64_t i = 0; i < nRecords; i++) {
+    const std::uint64_t offset = headerSize + i * recordSize;
+    std::uint64_t event = 0;
+    fFile.seekg(offset);
+    fFile.read(reinterpret_cast<char *>(&event), sizeof(event));
+    fIndex.emplace_back(event, offset);
+  }
+  std::sort(fIndex.begin(), fIndex.end());
+  return static_cast<G4bool>(fFile);
+}
+
+G4bool SeedJournal::Restore(std::uint64_t event,
+                            CLHEP::HepRandomEngine &engine) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  auto entry = std::lower_bound(
+      fIndex.begin(), fIndex.end(), event,
+      [](const std::pair<std::uint64_t, std::uint64_t> &indexEntry,
+         std::uint64_t value) { return indexEntry.first < value; });
+  if (entry == fIndex.end() || entry->first != event) {
+    G4cerr << "SeedJournal: event " << event << " not recorded" << G4endl;
+    return false;
+  }
+  fRecord.resize(1 + fStateSize);
+  fFile.seekg(entry->second);
+  fFile.read(reinterpret_cast<char *>(fRecord.data()),
+             fRecord.size() * sizeof(std::uint64_t));
+  if (!fFile || fRecord[0] != event) {
+    G4cerr << "SeedJournal: cannot read event " << event << G4endl;
+    return false;
+  }
+  const std::vector<unsigned long> state(fRecord.begin() + 1, fRecord.end());
+  return engine.get(state);
+}
+
+//**************************************************
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Compare two JSON outputs of G4HadFSBenchmark -b suite.
+
+Usage:
+    python3 comparebench.py baseline.json candidate.json [threshold_percent]
+
+Prints, for every grid point present in both files, the change of the
+interactions per second and of the allocations per call, and marks the
+points whose throughput dropped by more than the threshold (default 5%).
+Exits with 1 if any point regressed.
+"""
+
+import json
+import sys
+
+
+def load(file_name):
+    with open(file_name) as f:
+        data = json.load(f)
+    points = {}
+    for result in data["results"]:
+        key = (result["physics"], result["projectile"], result["energy_GeV"],
+               result["material"])
+        points[key] = result
+    return data["geant4"], points
+
+
+if __name__ == "__main__":
+    threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 5.0
+    version_a, baseline = load(sys.argv[1])
+    version_b, candidate = load(sys.argv[2])
+    print(f"Geant4 {version_a} -> {version_b}")
+    print(f"{'physics':<12} {'proj':<8} {'E(GeV)':>7} {'material':<7} "
+          f"{'int/s':>10} {'change':>8} {'allocs/call':>12}")
+    regressions = 0
+    for key in sorted(baseline.keys() & candidate.keys()):
+        a, b = baseline[key], candidate[key]
+        change = 100.0 * (b["interactions_per_s"] / a["interactions_per_s"] - 1.0)
+        flag = ""
+        if change < -threshold:
+            flag = " <-- regression"
+            regressions += 1
+        print(f"{key[0]:<12} {key[1]:<8} {key[2]:>7g} {key[3]:<7} "
+              f"{b['interactions_per_s']:>10.1f} {change:>+7.1f}% "
+              f"{a['allocations_per_call']:>5.0f}->{b['allocations_per_call']:<5.0f}{flag}")
+    for key in sorted(baseline.keys() ^ candidate.keys()):
+        print(f"only in {'baseline' if key in baseline else 'candidate'}: {key}")
+    print(f"peak RSS (MB): {max(p['peak_rss_MB'] for p in baseline.values()):.1f} -> "
+          f"{max(p['peak_rss_MB'] for p in candidate.values()):.1f}")
+    sys.exit(1 if regressions else 0)
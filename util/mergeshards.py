@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""Merge the outputs of a run split with G4HadFSGenerator -shard k/N.
+
+Usage:
+    python3 mergeshards.py FTFP_BERTpi-10.0G4_Cu_shard*of100.json
+
+Reads the sidecar JSON of every shard, checks that the N shards of the run
+are all present, come from the same physics case, run seed and Geant4
+version and cover the event range without gaps, then writes next to them,
+without the _shardKofN suffix:
+- the ROOT file, histograms added shard by shard (PyROOT),
+- the ntuple, if the shards have one, chunks copied shard by shard with the
+  model column remapped to a merged model table,
+- a JSON with the merged metadata.
+Only one shard file is open at a time and the ntuple is copied chunk by
+chunk, so the memory used does not grow with the number of shards.
+"""
+
+import json
+import re
+import struct
+import sys
+
+import numpy as np
+
+COMMON_KEYS = ("shards", "run_seed", "geant4_version", "geant4_version_number",
+               "physics", "projectile", "energy", "material")
+
+
+def load_shards(file_names):
+    """Return the shard metadata sorted by shard, after consistency checks."""
+    shards = []
+    for file_name in file_names:
+        with open(file_name) as f:
+            shards.append(json.load(f))
+    shards.sort(key=lambda shard: shard["shard"])
+    first = shards[0]
+    for shard in shards:
+        for key in COMMON_KEYS:
+            if shard[key] != first[key]:
+                raise ValueError(f"{shard['stem']}: {key} differs from {first['stem']}")
+    indices = [shard["shard"] for shard in shards]
+    if indices != list(range(first["shards"])):
+        missing = sorted(set(range(first["shards"])) - set(indices))
+        raise ValueError(f"missing or duplicate shards, missing: {missing}")
+    for previous, shard in zip(shards, shards[1:]):
+        if shard["first_event"] != previous["last_event"]:
+            raise ValueError(f"{shard['stem']}: event range not contiguous")
+    return shards
+
+
+def merge_histograms(shards, output_name):
+    """Add the histograms of the shard ROOT files into output_name."""
+    import ROOT
+
+    merged = {}
+    order = []
+    for shard in shards:
+        shard_file = ROOT.TFile.Open(shard["root"])
+        if not shard_file or shard_file.IsZombie():
+            raise IOError(f"cannot open {shard['root']}")
+        for key in shard_file.GetListOfKeys():
+            histo = key.ReadObj()
+            if not histo.InheritsFrom("TH1"):
+                continue
+            name = histo.GetName()
+            if name in merged:
+                merged[name].Add(histo)
+            else:
+                histo.SetDirectory(ROOT.nullptr)
+                merged[name] = histo
+                order.append(name)
+        shard_file.Close()
+    output = ROOT.TFile(output_name, "RECREATE")
+    for name in order:
+        merged[name].Write(name)
+    output.Close()
+
+
+def read_header(f):
+    """Read an ntuple header, return (metadata, header bytes, column dtypes)."""
+    start = f.tell()
+    if f.read(8) != b"G4HFSNT1":
+        raise ValueError(f"{f.name} is not a G4HadFSGenerator ntuple")
+    (metadata_size,) = struct.unpack("<I", f.read(4))
+    metadata = f.read(metadata_size).decode()
+    columns_start = f.tell()
+    (n_columns,) = struct.unpack("<I", f.read(4))
+    dtypes = []
+    for _ in range(n_columns):
+        size, kind, name_size = struct.unpack("<BcB", f.read(3))
+        name = f.read(name_size).decode()
+        dtypes.append((name, np.dtype(f"<{kind.decode()}{size}")))
+    end = f.tell()
+    f.seek(columns_start)
+    columns = f.read(end - columns_start)
+    f.seek(end)
+    return metadata, columns, dtypes, end - start
+
+
+def read_models(f, dtypes):
+    """Skip the chunks (seeking) and return the model table of the file."""
+    row_size = sum(dtype.itemsize for _, dtype in dtypes)
+    while True:
+        tag = f.read(4)
+        if tag != b"CHNK":
+            break
+        (rows,) = struct.unpack("<Q", f.read(8))
+        f.seek(rows * row_size, 1)
+    models = []
+    if tag == b"MODL":
+        (n_models,) = struct.unpack("<I", f.read(4))
+        for _ in range(n_models):
+            (size,) = struct.unpack("<H", f.read(2))
+            models.append(f.read(size).decode())
+        tag = f.read(4)
+    if tag != b"END!":
+        raise ValueError(f"{f.name} is truncated")
+    return models
+
+
+def merge_ntuples(shards, output_name, metadata):
+    """Concatenate the shard ntuples into output_name, chunk by chunk."""
+    merged_models = []
+    with open(output_name, "wb") as output:
+        reference_columns = None
+        for shard in shards:
+            with open(shard["ntuple"], "rb") as f:
+                _, columns, dtypes, header_size = read_header(f)
+                if reference_columns is None:
+                    reference_columns = columns
+                    encoded = metadata.encode()
+                    output.write(b"G4HFSNT1")
+                    output.write(struct.pack("<I", len(encoded)))
+                    output.write(encoded)
+                    output.write(columns)
+                elif columns != reference_columns:
+                    raise ValueError(f"{shard['ntuple']}: columns differ")
+
+                # Model ids of the shard -> ids in the merged table
+                #
+                remap = []
+                for model in read_models(f, dtypes):
+                    if model not in merged_models:
+                        merged_models.append(model)
+                    remap.append(merged_models.index(model))
+                remap = np.array(remap or [0], dtype=np.int16)
+
+                f.seek(header_size)
+                while f.read(4) == b"CHNK":
+                    (rows,) = struct.unpack("<Q", f.read(8))
+                    output.write(b"CHNK")
+                    output.write(struct.pack("<Q", rows))
+                    for name, dtype in dtypes:
+                        column = f.read(rows * dtype.itemsize)
+                        if name == "model":
+                            model = np.frombuffer(column, dtype)
+                            column = np.where(model >= 0, remap[np.maximum(model, 0)],
+                                              model).astype(dtype).tobytes()
+                        output.write(column)
+        output.write(b"MODL")
+        output.write(struct.pack("<I", len(merged_models)))
+        for model in merged_models:
+            encoded = model.encode()
+            output.write(struct.pack("<H", len(encoded)))
+            output.write(encoded)
+        output.write(b"END!")
+
+
+if __name__ == "__main__":
+    shards = load_shards(sys.argv[1:])
+    first, last = shards[0], shards[-1]
+    stem = re.sub(r"_shard\d+of\d+$", "", first["stem"])
+    merge_histograms(shards, stem + ".root")
+    merged = {key: first[key] for key in COMMON_KEYS}
+    merged.update(first_event=first["first_event"], last_event=last["last_event"],
+                  stem=stem, root=stem + ".root", ntuple="")
+    if all(shard["ntuple"] for shard in shards):
+        metadata = (f"physics={first['physics']} projectile={first['projectile']} "
+                    f"energy={first['energy']} material={first['material']} "
+                    f"seed={first['run_seed']} shards={first['shards']} "
+                    f"events={first['first_event']}:{last['last_event']}")
+        merged["ntuple"] = stem + "_ntuple.bin"
+        merge_ntuples(shards, merged["ntuple"], metadata)
+    with open(stem + ".json", "w") as f:
+        json.dump(merged, f, indent=2)
+    print(f"merged {len(shards)} shards into {stem}.root"
+          + (f" and {merged['ntuple']}" if merged["ntuple"] else ""))
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""Read the binary event records written by G4HadFSGenerator -eventfile binary.
+
+Usage as a module:
+    from readevents import read_events
+    metadata, events = read_events("FTFP_BERTpi-10.0G4_Cu_events.bin")
+    for event, particles in events:
+        particles["pdg"], particles["px"]  # numpy arrays, GeV
+        # particles 0 and 1 are the projectile and the target (status 4)
+
+Usage from the command line prints a short summary:
+    python3 readevents.py FTFP_BERTpi-10.0G4_Cu_events.bin
+"""
+
+import struct
+import sys
+
+import numpy as np
+
+PARTICLE = np.dtype([("pdg", "<i4"), ("status", "<i4"), ("px", "<f8"),
+                     ("py", "<f8"), ("pz", "<f8"), ("e", "<f8"), ("m", "<f8")])
+
+
+def read_events(file_name):
+    """Return (metadata string, generator of (event, particles array))."""
+    f = open(file_name, "rb")
+    if f.read(8) != b"G4HFSEV1":
+        raise ValueError(f"{file_name} is not a G4HadFSGenerator event file")
+    (metadata_size,) = struct.unpack("<I", f.read(4))
+    metadata = f.read(metadata_size).decode()
+
+    def events():
+        with f:
+            while True:
+                (size,) = struct.unpack("<I", f.read(4))
+                if size == 0:
+                    if f.read(4) != b"END!":
+                        raise ValueError(f"{file_name} is truncated")
+                    return
+                record = f.read(size)
+                event, n_particles = struct.unpack_from("<QI", record)
+                yield event, np.frombuffer(record, PARTICLE, n_particles, 12)
+
+    return metadata, events()
+
+
+if __name__ == "__main__":
+    metadata, events = read_events(sys.argv[1])
+    print(metadata)
+    n_events = 0
+    n_secondaries = 0
+    for event, particles in events:
+        n_events += 1
+        n_secondaries += len(particles) - 2
+    print(f"events: {n_events}, secondaries per event: {n_secondaries / max(n_events, 1):.2f}")
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Read the columnar ntuple written by G4HadFSGenerator -ntuple 1.
+
+Usage as a module:
+    from readntuple import read_ntuple
+    metadata, columns, models = read_ntuple("FTFP_BERTpi-10.0G4_Cu_ntuple.bin")
+    columns["ekin"]  # numpy array, MeV
+
+Usage from the command line prints a short summary:
+    python3 readntuple.py FTFP_BERTpi-10.0G4_Cu_ntuple.bin
+"""
+
+import struct
+import sys
+
+import numpy as np
+
+
+def read_ntuple(file_name):
+    """Return (metadata string, dict of numpy columns, list of model names)."""
+    with open(file_name, "rb") as f:
+        data = f.read()
+    if data[:8] != b"G4HFSNT1":
+        raise ValueError(f"{file_name} is not a G4HadFSGenerator ntuple")
+    offset = 8
+    (metadata_size,) = struct.unpack_from("<I", data, offset)
+    offset += 4
+    metadata = data[offset : offset + metadata_size].decode()
+    offset += metadata_size
+    (n_columns,) = struct.unpack_from("<I", data, offset)
+    offset += 4
+    dtypes = []
+    for _ in range(n_columns):
+        size, kind, name_size = struct.unpack_from("<BcB", data, offset)
+        offset += 3
+        name = data[offset : offset + name_size].decode()
+        offset += name_size
+        dtypes.append((name, np.dtype(f"{kind.decode()}{size}")))
+
+    chunks = {name: [] for name, _ in dtypes}
+    while data[offset : offset + 4] == b"CHNK":
+        (rows,) = struct.unpack_from("<Q", data, offset + 4)
+        offset += 12
+        for name, dtype in dtypes:
+            chunks[name].append(np.frombuffer(data, dtype, rows, offset))
+            offset += rows * dtype.itemsize
+
+    models = []
+    if data[offset : offset + 4] == b"MODL":
+        (n_models,) = struct.unpack_from("<I", data, offset + 4)
+        offset += 8
+        for _ in range(n_models):
+            (size,) = struct.unpack_from("<H", data, offset)
+            models.append(data[offset + 2 : offset + 2 + size].decode())
+            offset += 2 + size
+    if data[offset : offset + 4] != b"END!":
+        raise ValueError(f"{file_name} is truncated")
+
+    columns = {
+        name: np.concatenate(chunks[name]) if chunks[name] else np.empty(0, dtype)
+        for name, dtype in dtypes
+    }
+    return metadata, columns, models
+
+
+if __name__ == "__main__":
+    metadata, columns, models = read_ntuple(sys.argv[1])
+    print(metadata)
+    print(f"secondaries: {len(columns['event'])}")
+    print(f"events with secondaries: {len(np.unique(columns['event']))}")
+    for index, model in enumerate(models):
+        print(f"model {index}: {model} ({np.count_nonzero(columns['model'] == index)} secondaries)")